@@ -11,8 +11,6 @@ struct Boid
 {
     gfx::math::Vec2d position;
     gfx::math::Vec2d velocity;
-
-    std::shared_ptr<gfx::primitives::Polyline2D> shape;
 };
 
 class BoidsDemo : public demos::common::core::GfxDemo
@@ -64,6 +62,7 @@ private:
 
     int num_boids = 500;
     std::vector<std::shared_ptr<Boid>> boids;
+    std::shared_ptr<gfx::primitives::Instances2D> boid_instances;
 
     double boid_scale = 0.8;
 
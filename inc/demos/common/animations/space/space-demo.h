@@ -1,6 +1,7 @@
 #ifndef SPACE_DEMO_H
 #define SPACE_DEMO_H
 
+#include <deque>
 #include <unordered_map>
 #include <gfx/core/render-2D.h>
 #include <demos/common/core/gfx-demo.h>
@@ -33,7 +34,7 @@ public:
     SpaceDemo(const std::shared_ptr<gfx::core::Render2D> renderer) : 
         GfxDemo(renderer), 
         body_items(std::unordered_map<std::shared_ptr<Body>, RenderBody>()),
-        body_trails(std::unordered_map<std::shared_ptr<Body>, std::vector<gfx::math::Vec2d>>()) {}
+        body_trails(std::unordered_map<std::shared_ptr<Body>, std::deque<gfx::math::Vec2d>>()) {}
 
 
     void init() override;
@@ -150,7 +151,9 @@ private:
     bool trails_visible { false };
     int trail_length { 100 };
     double trail_point_spacing_au { 0.01 };
-    std::unordered_map<std::shared_ptr<Body>, std::vector<gfx::math::Vec2d>> body_trails;
+    std::unordered_map<std::shared_ptr<Body>, std::deque<gfx::math::Vec2d>> body_trails;
+    gfx::math::Box2d trail_cull_bounds;
+    bool trail_culling_dirty { true };
 
     std::unordered_map<std::shared_ptr<Body>, RenderBody> body_items;
     std::vector<std::shared_ptr<Body>> body_list;
@@ -2,6 +2,7 @@
 #define VIDEO_DEMO_H
 
 #include <gfx/core/render-2D.h>
+#include <gfx/utils/image-sequence.h>
 #include <demos/common/core/gfx-demo.h>
 
 namespace demos::common::animations::video
@@ -42,12 +43,18 @@ private:
     void load_bad_apple();
     void load_p5();
 
+    static constexpr int NUM_FRAMES { 6573 };
+    static constexpr std::size_t FRAMES_AHEAD { 8 };
+
     std::vector<gfx::core::types::Color4> palette;
     std::vector<Video> videos { Video::BAD_APPLE, Video::P5 };
     int current_video { 0 };
     std::string video_name;
 
-    std::shared_ptr<gfx::primitives::Bitmap2D> bitmap { renderer->create_bitmap({ 0, 0 }, { 800, 600 }) };
+    // Frames are swapped into the bitmap the primitive draws from, so showing one copies nothing.
+    std::shared_ptr<gfx::core::types::Bitmap> frame { std::make_shared<gfx::core::types::Bitmap>(gfx::math::Vec2i { 800, 600 }) };
+    std::shared_ptr<gfx::primitives::Bitmap2D> bitmap { renderer->create_bitmap({ 0, 0 }, frame) };
+    std::unique_ptr<gfx::utils::ImageSequence> sequence;
     double time_since_last_frame { 0.0 };
     int frame_number { 1 };
     bool paused { false };
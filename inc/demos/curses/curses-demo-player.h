@@ -16,13 +16,19 @@ public:
 
     CursesDemoPlayer() : demos::common::core::DemoPlayer()
     {
-        auto surface { std::make_shared<gfx::surfaces::CursesRenderSurface>(demos::curses::get_screen_size() * 2) };
-        renderer = std::make_shared<gfx::core::Render2D>(surface, gfx::math::Vec2d { 2, 1 });
+        gfx::surfaces::CursesSurfaceMode mode { demos::curses::supports_truecolor() 
+            ? gfx::surfaces::CursesSurfaceMode::TRUECOLOR 
+            : gfx::surfaces::CursesSurfaceMode::PALETTE };
+
+        // Keep pixels square: a cell is twice as tall as it is wide.
+        gfx::math::Vec2i cell_size { gfx::surfaces::CursesRenderSurface::get_cell_size(mode) };
+        surface = std::make_shared<gfx::surfaces::CursesRenderSurface>(demos::curses::get_screen_size() * cell_size, mode);
+        renderer = std::make_shared<gfx::core::Render2D>(surface, gfx::math::Vec2d { 2, cell_size.y / 2.0 });
     }
 
     gfx::math::Vec2i get_screen_size() override
     {
-        return demos::curses::get_screen_size() * 2;
+        return demos::curses::get_screen_size() * surface->get_cell_size();
     }
 
     int get_input() override
@@ -44,9 +50,24 @@ public:
 
     void draw_info() override
     {
+        std::vector<std::string> info = get_info();
+
+        // Truecolor output bypasses curses, so the text goes out with the next frame instead.
+        if (surface->get_mode() == gfx::surfaces::CursesSurfaceMode::TRUECOLOR)
+        {
+            for (std::size_t i = 0; i < info.size(); ++i)
+            {
+                surface->draw_text({ 0, static_cast<int>(i) }, info[i], { 255, 255, 255 });
+            }
+            return;
+        }
+
         demos::curses::set_bold(true);
         demos::curses::set_color(demos::curses::default_color::WHITE);
-        std::vector<std::string> info = get_info();
+
+        // The surface only rewrites cells it changed, so have it repaint under the text.
+        surface->invalidate_text({ 0, 0 }, info);
+
         for (int i = 0; i < info.size(); ++i)
         {
             add_str({ 0, i }, info[i]);
@@ -55,6 +76,8 @@ public:
 
 private:
 
+    std::shared_ptr<gfx::surfaces::CursesRenderSurface> surface;
+
     demos::common::core::MouseEvent curses_to_mouse_event(const MEVENT e)
     {
         demos::common::core::MouseEvent event;
@@ -83,7 +106,7 @@ private:
             default:
                 break;
         }
-        gfx::math::Vec2d position = gfx::math::Vec2i { e.x, e.y } * 2 / renderer->get_viewport_scaling();
+        gfx::math::Vec2d position = gfx::math::Vec2i { e.x, e.y } * surface->get_cell_size() / renderer->get_viewport_scaling();
         event.position = position / renderer->get_resolution();
         return event;
     }
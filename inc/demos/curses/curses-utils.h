@@ -1,6 +1,7 @@
 #ifndef DEMO_UTILS_H
 #define DEMO_UTILS_H
 
+#include <cstdlib>
 #include <locale.h>
 #include <string>
 #include <ncurses.h>
@@ -37,6 +38,13 @@ inline gfx::math::Vec2i get_screen_size()
     return { width, height };
 }
 
+// Terminals that understand 24-bit color escapes advertise it through COLORTERM.
+inline bool supports_truecolor()
+{
+    const char* colorterm { std::getenv("COLORTERM") };
+    return colorterm && (std::string { colorterm } == "truecolor" || std::string { colorterm } == "24bit");
+}
+
 inline int get_input()
 {
     return getch();
@@ -12,6 +12,7 @@
 #include <gfx/primitives/polygon-2D.h>
 #include <gfx/primitives/text-2D.h>
 #include <gfx/primitives/bitmap-2D.h>
+#include <gfx/primitives/instances-2D.h>
 #include <gfx/text/font-manager-ttf.h>
 #include <gfx/debug/debug-viewer.h>
 
@@ -79,6 +80,13 @@ public:
         return create_bitmap(gfx::math::Vec2d { x, y }, bm);
     };
 
+    // The primitive draws from the shared bitmap directly instead of taking a copy.
+    std::shared_ptr<gfx::primitives::Bitmap2D> create_bitmap(const gfx::math::Vec2d position, const std::shared_ptr<types::Bitmap> &bm) const;
+    std::shared_ptr<gfx::primitives::Bitmap2D> create_bitmap(const double x, const double y, const std::shared_ptr<types::Bitmap> &bm) const 
+    {
+        return create_bitmap(gfx::math::Vec2d { x, y }, bm);
+    };
+
     std::shared_ptr<gfx::primitives::Bitmap2D> create_bitmap(const gfx::math::Vec2d position, const gfx::math::Vec2i resolution) const;
     std::shared_ptr<gfx::primitives::Bitmap2D> create_bitmap(const double x, const double y, const gfx::math::Vec2i resolution) const 
     {
@@ -91,6 +99,8 @@ public:
         return create_text(gfx::math::Vec2d { x, y }, text, font, font_size, color);
     };
 
+    std::shared_ptr<gfx::primitives::Instances2D> create_instances(const std::shared_ptr<Primitive2D> prototype, const std::vector<gfx::primitives::Instance2D> &instances = {}) const;
+
     bool collides(const gfx::math::Vec2d point, const std::shared_ptr<Primitive2D>) const;
     bool collides(const double x, const double y, const std::shared_ptr<Primitive2D> primitive) const
     {
@@ -146,7 +156,7 @@ public:
     inline bool is_font_loaded(const std::string &name) const { return font_manager->is_font_loaded(name); }
     inline bool fonts_empty() const { return font_manager->get_loaded_fonts().empty(); }
 
-    inline void load_font_directory(const std::filesystem::path &path = "") { font_manager->load_font_directory(path); }
+    inline gfx::text::FontDirectoryReport load_font_directory(const std::filesystem::path &path = "") { return font_manager->load_font_directory(path); }
 
     inline std::shared_ptr<gfx::text::FontTTF> get_font(const std::string &name) const { return font_manager->get_font(name); }
 
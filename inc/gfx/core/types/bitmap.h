@@ -1,177 +1,271 @@
 #ifndef BITMAP_H
 #define BITMAP_H
 
-#include <fstream>
-#include <stdexcept>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 #include <gfx/core/types/color4.h>
+#include <gfx/core/types/palette.h>
 #include <gfx/math/vec2.h>
 
 namespace gfx::core::types
 {
 
+// ROW_MAJOR stores rows one after another. TILED stores 16x16 blocks, each block row-major,
+// so that samples walking the image in any direction stay within a few cache lines.
+enum class BitmapLayout
+{
+    ROW_MAJOR,
+    TILED
+};
+
 class Bitmap
 {
 
 public:
 
-    Bitmap(const gfx::math::Vec2i resolution)
-        : resolution(resolution), pixels(std::vector<Color4>(resolution.x * resolution.y, gfx::core::types::Color4 { 0, 0, 0, 255 })) 
+    static constexpr int TILE_BITS { 4 };
+    static constexpr int TILE_SIZE { 1 << TILE_BITS };
+
+    Bitmap(const gfx::math::Vec2i resolution, const BitmapLayout layout = BitmapLayout::ROW_MAJOR)
+        : resolution(resolution), layout(layout)
     {
         if (resolution.x <= 0 || resolution.y <= 0)
         {
             this->resolution = { 1, 1 };
-            pixels.resize(1, gfx::core::types::Color4 { 0, 0, 0, 255 });
         }
+        pixels.resize(storage_size(layout, this->resolution), gfx::core::types::Color4 { 0, 0, 0, 255 });
     }
 
-    void resize(const gfx::math::Vec2i new_resolution)
+    template <BitmapLayout Layout>
+    static inline std::size_t pixel_index(const gfx::math::Vec2i resolution, const int x, const int y)
     {
-        resolution = new_resolution;
-        pixels.resize(resolution.x * resolution.y, gfx::core::types::Color4 { 0, 0, 0, 255 });
+        if constexpr (Layout == BitmapLayout::TILED)
+        {
+            std::size_t tiles_x { static_cast<std::size_t>((resolution.x + TILE_SIZE - 1) >> TILE_BITS) };
+            std::size_t tile { (y >> TILE_BITS) * tiles_x + (x >> TILE_BITS) };
+            return (tile << (2 * TILE_BITS)) | ((y & (TILE_SIZE - 1)) << TILE_BITS) | (x & (TILE_SIZE - 1));
+        }
+        else
+        {
+            return static_cast<std::size_t>(y) * resolution.x + x;
+        }
     }
 
-    void set_pixel(const gfx::math::Vec2i pos, const gfx::core::types::Color4 color)
+    static inline std::size_t pixel_index(const BitmapLayout layout, const gfx::math::Vec2i resolution, const int x, const int y)
     {
-        if (pos.x < 0 || pos.y < 0 || pos.x >= resolution.x || pos.y >= resolution.y)
+        return layout == BitmapLayout::TILED
+            ? pixel_index<BitmapLayout::TILED>(resolution, x, y)
+            : pixel_index<BitmapLayout::ROW_MAJOR>(resolution, x, y);
+    }
+
+    // Tiled storage is padded out to whole tiles.
+    static inline std::size_t storage_size(const BitmapLayout layout, const gfx::math::Vec2i resolution)
+    {
+        if (layout == BitmapLayout::TILED)
         {
-            return;
+            std::size_t tiles_x { static_cast<std::size_t>((resolution.x + TILE_SIZE - 1) >> TILE_BITS) };
+            std::size_t tiles_y { static_cast<std::size_t>((resolution.y + TILE_SIZE - 1) >> TILE_BITS) };
+            return (tiles_x * tiles_y) << (2 * TILE_BITS);
         }
-        pixels[pos.x + pos.y * resolution.x] = color;
+        return static_cast<std::size_t>(resolution.x) * resolution.y;
     }
 
-    Color4 get_pixel(const gfx::math::Vec2i pos) const
+    // Reorders the pixels, and those of any mip levels, into the given layout.
+    void set_layout(const BitmapLayout new_layout)
     {
-        if (pos.x < 0 || pos.y < 0 || pos.x >= resolution.x || pos.y >= resolution.y)
+        bool levels_current { has_current_mipmaps() };
+        if (new_layout != layout)
         {
-            return gfx::core::types::Color4 { 0, 0, 0, 255 };
+            std::vector<Color4> reordered(storage_size(new_layout, resolution), gfx::core::types::Color4 { 0, 0, 0, 0 });
+            for (int y = 0; y < resolution.y; ++y)
+            {
+                for (int x = 0; x < resolution.x; ++x)
+                {
+                    reordered[pixel_index(new_layout, resolution, x, y)] = pixels[pixel_index(layout, resolution, x, y)];
+                }
+            }
+            pixels = std::move(reordered);
+            layout = new_layout;
+            touch();
+        }
+
+        for (auto &level : mipmaps)
+        {
+            level.set_layout(new_layout);
+        }
+        if (levels_current)
+        {
+            mipmaps_version = version;
         }
-        return pixels[pos.x + pos.y * resolution.x];
     }
 
-    void fill(const gfx::core::types::Color4 color = gfx::core::types::Color4 { 0, 0, 0, 255 })
+    void resize(const gfx::math::Vec2i new_resolution)
     {
-        std::fill(pixels.begin(), pixels.end(), color);
+        resolution = new_resolution;
+        pixels.resize(storage_size(layout, resolution), gfx::core::types::Color4 { 0, 0, 0, 255 });
+        mipmaps.clear();
+        touch();
     }
 
-    void compress_colors(const std::vector<Color4>& palette)
+    // Whole-bitmap changes made through these methods move the bitmap to a new version, unique
+    // across all bitmaps, so views of a shared bitmap can tell when it changed. Pixel writes
+    // through set_pixel(), at() or pixels do not; the writer calls touch() once per batch.
+    inline void touch() { version = next_version(); }
+    inline uint64_t get_version() const { return version; }
+
+    // Unchecked access for callers that have already clipped to the resolution.
+    inline Color4 &at(const int x, const int y) { return pixels[pixel_index(layout, resolution, x, y)]; }
+    inline const Color4 &at(const int x, const int y) const { return pixels[pixel_index(layout, resolution, x, y)]; }
+
+    // Visits every pixel in storage order, which for a tiled bitmap is one tile at a time.
+    template <typename Function>
+    void for_each_pixel(Function &&function)
     {
-        for(auto& pixel : pixels)
+        int step { layout == BitmapLayout::TILED ? TILE_SIZE : std::max(resolution.x, resolution.y) };
+        for (int tile_y = 0; tile_y < resolution.y; tile_y += step)
         {
-            auto it = std::min_element(palette.begin(), palette.end(), [&pixel](const Color4& a, const Color4& b) {
-                return Color4::distance(a, pixel) < Color4::distance(b, pixel);
-            });
-            if(it != palette.end())
+            for (int tile_x = 0; tile_x < resolution.x; tile_x += step)
             {
-                pixel = *it;
+                for (int y = tile_y; y < std::min(tile_y + step, resolution.y); ++y)
+                {
+                    for (int x = tile_x; x < std::min(tile_x + step, resolution.x); ++x)
+                    {
+                        function(x, y, at(x, y));
+                    }
+                }
             }
         }
     }
 
-    static Bitmap decode_bmp(const std::string& filename)
+    // Clipped write that leaves the version alone; see touch().
+    void set_pixel(const gfx::math::Vec2i pos, const gfx::core::types::Color4 color)
     {
-        std::ifstream file{ filename, std::ios::binary };
-        if(!file)
+        if (pos.x < 0 || pos.y < 0 || pos.x >= resolution.x || pos.y >= resolution.y)
         {
-            throw std::runtime_error{ "Failed to open BMP file: " + filename };
+            return;
         }
+        at(pos.x, pos.y) = color;
+    }
 
-        // BMP Header
-        uint16_t file_type{};
-        file.read(reinterpret_cast<char*>(&file_type), 2);
-        if(file_type != 0x4D42) // 'BM'
+    Color4 get_pixel(const gfx::math::Vec2i pos) const
+    {
+        if (pos.x < 0 || pos.y < 0 || pos.x >= resolution.x || pos.y >= resolution.y)
         {
-            throw std::runtime_error{ "Not a valid BMP file" };
+            return gfx::core::types::Color4 { 0, 0, 0, 255 };
         }
+        return at(pos.x, pos.y);
+    }
 
-        file.ignore(8); // Skip file size and reserved fields
-
-        uint32_t data_offset{};
-        file.read(reinterpret_cast<char*>(&data_offset), 4);
+    void fill(const gfx::core::types::Color4 color = gfx::core::types::Color4 { 0, 0, 0, 255 })
+    {
+        std::fill(pixels.begin(), pixels.end(), color);
+        touch();
+    }
 
-        // DIB Header
-        uint32_t dib_header_size{};
-        file.read(reinterpret_cast<char*>(&dib_header_size), 4);
+    // Maps every pixel, and every mip level, to its nearest palette color.
+    void compress_colors(const std::vector<Color4>& palette, const Dither dither = Dither::NONE)
+    {
+        compress_colors(Palette { palette }, dither);
+    }
 
-        if(dib_header_size < 40)
+    void compress_colors(const Palette& palette, const Dither dither = Dither::NONE)
+    {
+        bool levels_current { has_current_mipmaps() };
+        palette.quantize(*this, dither);
+        for(auto& level : mipmaps)
         {
-            throw std::runtime_error{ "Unsupported BMP format: DIB header too small" };
+            palette.quantize(level, dither);
         }
-
-        int32_t width{}, height{};
-        file.read(reinterpret_cast<char*>(&width), 4);
-        file.read(reinterpret_cast<char*>(&height), 4);
-
-        uint16_t planes{}, bit_count{};
-        file.read(reinterpret_cast<char*>(&planes), 2);
-        file.read(reinterpret_cast<char*>(&bit_count), 2);
-
-        uint32_t compression{};
-        file.read(reinterpret_cast<char*>(&compression), 4);
-
-        // Skip image size, resolution, and color table entries (16 bytes)
-        file.ignore(16);
-
-        // Skip rest of header if longer than 40 bytes
-        uint32_t extra_header_bytes = dib_header_size > 40 ? dib_header_size - 40 : 0;
-        if(extra_header_bytes > 0)
+        touch();
+        if (levels_current)
         {
-            file.ignore(extra_header_bytes);
+            mipmaps_version = version;
         }
+    }
 
-        // Skip color masks if using BI_BITFIELDS
-        if(compression == 3) // BI_BITFIELDS
-        {
-            // Bitfields are 3 DWORDs for RGB, sometimes 4 for RGBA (depends on header)
-            uint32_t mask_count = (dib_header_size >= 56) ? 4 : 3;
-            file.ignore(mask_count * 4);
-        }
+    // Halves each dimension with a 2x2 box filter. Colour is weighted by alpha so that
+    // transparent texels do not darken their neighbours.
+    Bitmap downsample() const
+    {
+        Bitmap half { gfx::math::Vec2i { std::max(1, resolution.x / 2), std::max(1, resolution.y / 2) }, layout };
 
-        if(planes != 1 || (bit_count != 24 && bit_count != 32))
+        for (int y = 0; y < half.resolution.y; ++y)
         {
-            throw std::runtime_error{ "Unsupported BMP: Only 24-bit or 32-bit images supported" };
-        }
+            int y0 { std::min(2 * y, resolution.y - 1) };
+            int y1 { std::min(2 * y + 1, resolution.y - 1) };
 
-        if(compression != 0 && compression != 3)
-        {
-            throw std::runtime_error{ "Unsupported BMP: Compressed BMPs not supported" };
+            for (int x = 0; x < half.resolution.x; ++x)
+            {
+                int x0 { std::min(2 * x, resolution.x - 1) };
+                int x1 { std::min(2 * x + 1, resolution.x - 1) };
+                const Color4* samples[4] { &at(x0, y0), &at(x1, y0), &at(x0, y1), &at(x1, y1) };
+
+                int r { 0 }, g { 0 }, b { 0 }, a { 0 };
+                for (const Color4* sample : samples)
+                {
+                    r += sample->r * sample->a;
+                    g += sample->g * sample->a;
+                    b += sample->b * sample->a;
+                    a += sample->a;
+                }
+
+                half.at(x, y) = a == 0
+                    ? Color4 { 0, 0, 0, 0 }
+                    : Color4 { r / a, g / a, b / a, (a + 2) / 4 };
+            }
         }
 
-        // Go to pixel data
-        file.seekg(data_offset, std::ios::beg);
+        return half;
+    }
 
-        int row_padded = ((bit_count * width + 31) / 32) * 4;
-        int bytes_per_pixel = bit_count / 8;
+    // Levels 1 and up, each half the size of the one before, down to 1x1.
+    std::vector<Bitmap> make_mipmaps() const
+    {
+        std::vector<Bitmap> levels;
+        const Bitmap* level { this };
+        while (level->resolution.x > 1 || level->resolution.y > 1)
+        {
+            levels.push_back(level->downsample());
+            level = &levels.back();
+        }
+        return levels;
+    }
 
-        Bitmap bmp{ gfx::math::Vec2i{ width, std::abs(height) } };
-        bool flip_vertically{ height > 0 };
+    // The levels remember the version they were built from. Any later write to the pixels
+    // moves the bitmap on, and the stale levels are ignored until they are built again.
+    inline void build_mipmaps() { mipmaps = make_mipmaps(); mipmaps_version = version; }
+    inline bool has_current_mipmaps() const { return !mipmaps.empty() && mipmaps_version == version; }
 
-        std::vector<uint8_t> row_data(row_padded);
+    inline void clear_mipmaps() { mipmaps.clear(); }
 
-        for(int y = 0; y < std::abs(height); ++y)
+    // Level 0 is the bitmap itself.
+    inline int num_levels() const { return has_current_mipmaps() ? 1 + static_cast<int>(mipmaps.size()) : 1; }
+    inline const Bitmap &get_level(const int level) const
+    {
+        if (level <= 0 || !has_current_mipmaps())
         {
-            file.read(reinterpret_cast<char*>(row_data.data()), row_padded);
-            int bmp_y = flip_vertically ? (std::abs(height) - 1 - y) : y;
-
-            for(int x = 0; x < width; ++x)
-            {
-                int idx = x * bytes_per_pixel;
-                uint8_t b = row_data[idx];
-                uint8_t g = row_data[idx + 1];
-                uint8_t r = row_data[idx + 2];
-                uint8_t a = (bit_count == 32) ? row_data[idx + 3] : 255;
-
-                Color4 color{ r, g, b, a };
-                bmp.set_pixel(gfx::math::Vec2i{ x, bmp_y }, color);
-            }
+            return *this;
         }
-
-        return bmp;
+        return mipmaps[std::min(level, static_cast<int>(mipmaps.size())) - 1];
     }
 
     gfx::math::Vec2i resolution;
+    BitmapLayout layout = BitmapLayout::ROW_MAJOR;
     std::vector<Color4> pixels;
+    std::vector<Bitmap> mipmaps;
+
+private:
+
+    static uint64_t next_version()
+    {
+        static std::atomic<uint64_t> counter { 0 };
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    uint64_t version = next_version();
+    uint64_t mipmaps_version = 0;
 
 };
 
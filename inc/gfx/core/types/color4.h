@@ -82,7 +82,6 @@ public:
     }
 
     bool operator==(const Color4 &other) const { return r == other.r && g == other.g && b == other.b && a == other.a; }
-    void operator=(const Color4 &other) { r = other.r; g = other.g; b = other.b; a = other.a; }
 
     inline float r_double() const { return r / 255.0f; }
     inline float g_double() const { return g / 255.0f; }
@@ -0,0 +1,63 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <cstdint>
+#include <vector>
+#include <gfx/core/types/color4.h>
+
+namespace gfx::core::types
+{
+
+class Bitmap;
+
+enum class Dither
+{
+    NONE,
+    ORDERED,
+    FLOYD_STEINBERG
+};
+
+// Maps colors to the nearest palette entry by Color4::distance. Opaque colors go through a
+// 32x32x32 cube: cells that only one entry can win resolve directly, and the rest keep the
+// short list of entries that can, so results match an exhaustive search.
+class Palette
+{
+
+public:
+
+    static constexpr int CUBE_BITS { 5 };
+    static constexpr int CUBE_SIZE { 1 << CUBE_BITS };
+
+    Palette(const std::vector<Color4> &colors);
+
+    std::size_t nearest_index(const Color4 color) const;
+    inline const Color4 &nearest(const Color4 color) const { return colors[nearest_index(color)]; }
+
+    // Rows are mapped in parallel, except for Floyd-Steinberg dithering, which carries
+    // error from row to row.
+    void quantize(Bitmap &bitmap, const Dither dither = Dither::NONE) const;
+
+    inline const std::vector<Color4> &get_colors() const { return colors; }
+    inline std::size_t size() const { return colors.size(); }
+    inline bool empty() const { return colors.empty(); }
+
+private:
+
+    std::size_t nearest_exhaustive(const Color4 color) const;
+    std::size_t nearest_opaque(const int r, const int g, const int b) const;
+
+    void quantize_rows(Bitmap &bitmap, const Dither dither, const int start_y, const int end_y) const;
+    void quantize_error_diffusion(Bitmap &bitmap) const;
+
+    std::vector<Color4> colors;
+
+    // Per cell, an offset into cell_candidates; a cell with a single candidate is resolved.
+    std::vector<uint32_t> cell_offsets;
+    std::vector<uint16_t> cell_candidates;
+
+    double ordered_spread = 0.0;
+};
+
+}
+
+#endif // PALETTE_H
@@ -7,8 +7,15 @@
 namespace gfx::geometry
 {
 
+static constexpr int MAX_BEZIER_SEGMENTS { 1024 };
+
+int quadratic_segment_count(const gfx::math::Vec2d p0, const gfx::math::Vec2d p1, const gfx::math::Vec2d p2, const double tolerance);
+
+void flatten_bezier(const gfx::math::Vec2d p0, const gfx::math::Vec2d p1, const gfx::math::Vec2d p2, const double tolerance, std::vector<gfx::math::Vec2d> &points);
+void flatten_contour(const std::vector<std::pair<gfx::math::Vec2d, bool>> &points_on_off_curve, const double tolerance, std::vector<gfx::math::Vec2d> &points);
+
 std::vector<gfx::math::Vec2d> flatten_bezier(const gfx::math::Vec2d p0, const gfx::math::Vec2d p1, const gfx::math::Vec2d p2, const double tolerance = 0.5);
-std::vector<gfx::math::Vec2d> flatten_contour(const std::vector<std::pair<gfx::math::Vec2d, bool>> &points_on_off_curve);
+std::vector<gfx::math::Vec2d> flatten_contour(const std::vector<std::pair<gfx::math::Vec2d, bool>> &points_on_off_curve, const double tolerance = 0.5);
 
 }
 
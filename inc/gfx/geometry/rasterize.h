@@ -13,6 +13,11 @@ namespace gfx::geometry
 
 void rasterize_filled_triangle(const Triangle &triangle, const core::types::Color4 color, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel);
 
+// Fills the transformed local ellipse with the given outer radii, leaving out pixels strictly
+// inside the inner ellipse. An inner radius of zero fills the whole ellipse. Rows are filled
+// between the analytic entry and exit points of both conics.
+void rasterize_ellipse(const gfx::math::Vec2d center, const gfx::math::Vec2d outer_radius, const gfx::math::Vec2d inner_radius, const gfx::math::Matrix3x3d &transform, const core::types::Color4 color, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel);
+
 
 static constexpr int CORNER_SEGMENTS = 8;
 static constexpr int MIN_MULTITHREAD_PIXELS { 200 * 200 };
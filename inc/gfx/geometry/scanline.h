@@ -0,0 +1,28 @@
+#ifndef SCANLINE_H
+#define SCANLINE_H
+
+#include <functional>
+#include <span>
+#include <vector>
+#include <gfx/math/vec2.h>
+#include <gfx/core/types/pixel.h>
+#include <gfx/core/types/color4.h>
+#include <gfx/geometry/types/edge.h>
+
+namespace gfx::geometry
+{
+
+enum class FillRule
+{
+    EVEN_ODD,
+    NON_ZERO
+};
+
+void append_contour_edges(const std::vector<gfx::math::Vec2d> &contour, std::vector<types::Edge> &edges);
+
+void rasterize_filled_spans(std::span<const types::Edge> edges, const FillRule fill_rule, const std::function<void(const int y, const int x0, const int x1)> emit_span);
+void rasterize_filled_edges(std::span<const types::Edge> edges, const FillRule fill_rule, const gfx::core::types::Color4 color, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel);
+
+}
+
+#endif // SCANLINE_H
@@ -0,0 +1,17 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include <span>
+#include <vector>
+#include <gfx/math/vec2.h>
+
+namespace gfx::geometry
+{
+
+// Appends the indices of the points kept by Douglas-Peucker simplification. Every dropped
+// point lies within tolerance of the simplified path; the first and last points are always kept.
+void simplify_polyline(std::span<const gfx::math::Vec2d> points, const double tolerance, std::vector<size_t> &kept);
+
+}
+
+#endif // SIMPLIFY_H
@@ -0,0 +1,47 @@
+#ifndef STROKE_H
+#define STROKE_H
+
+#include <vector>
+#include <gfx/math/vec2.h>
+#include <gfx/geometry/types/edge.h>
+
+namespace gfx::geometry
+{
+
+enum class LineJoin
+{
+    MITER,
+    BEVEL,
+    ROUND
+};
+
+enum class LineCap
+{
+    BUTT,
+    SQUARE,
+    ROUND
+};
+
+struct StrokeStyle
+{
+    double width = 1.0;
+    LineJoin join = LineJoin::MITER;
+    LineCap cap = LineCap::BUTT;
+    double miter_limit = 4.0;
+    double tolerance = 0.25;
+};
+
+// Appends the outline of the stroked polyline as closed contours. The outline
+// overlaps itself on the inside of joins, so it must be filled with FillRule::NON_ZERO.
+void stroke_polyline(const std::vector<gfx::math::Vec2d> &points, const bool closed, const StrokeStyle &style, std::vector<types::Edge> &edges);
+
+// Piecewise stroking for incrementally updated lines. Segment bodies, joins and caps are
+// separate closed contours of matching orientation, so any set of them filled together
+// with FillRule::NON_ZERO covers their union exactly once.
+void stroke_segment(const gfx::math::Vec2d p0, const gfx::math::Vec2d p1, const StrokeStyle &style, std::vector<types::Edge> &edges);
+void stroke_join(const gfx::math::Vec2d p0, const gfx::math::Vec2d pivot, const gfx::math::Vec2d p1, const StrokeStyle &style, std::vector<types::Edge> &edges);
+void stroke_cap(const gfx::math::Vec2d end, const gfx::math::Vec2d from, const StrokeStyle &style, std::vector<types::Edge> &edges);
+
+}
+
+#endif // STROKE_H
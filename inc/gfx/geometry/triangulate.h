@@ -1,6 +1,7 @@
 #ifndef TRIANGULATE_H
 #define TRIANGULATE_H
 
+#include <array>
 #include <vector>
 #include <gfx/math/vec2.h>
 #include <gfx/geometry/triangle.h>
@@ -9,6 +10,13 @@
 namespace gfx::geometry
 {
 
+struct Triangulation
+{
+    std::vector<gfx::math::Vec2d> vertices;
+    std::vector<std::array<int, 3>> indices;
+};
+
+Triangulation triangulate_polygon_indexed(const gfx::geometry::types::Component &component);
 std::vector<Triangle> triangulate_polygon(const gfx::geometry::types::Component &component);
 
 }
@@ -0,0 +1,17 @@
+#ifndef EDGE_H
+#define EDGE_H
+
+#include <gfx/math/vec2.h>
+
+namespace gfx::geometry::types
+{
+
+struct Edge
+{
+    gfx::math::Vec2d v0;
+    gfx::math::Vec2d v1;
+};
+
+}
+
+#endif // EDGE_H
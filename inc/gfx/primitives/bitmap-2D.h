@@ -1,6 +1,8 @@
 #ifndef BITMAP_2D_H
 #define BITMAP_2D_H
 
+#include <cstdint>
+#include <memory>
 #include <gfx/core/render-surface.h>
 #include <gfx/core/primitive-2D.h>
 #include <gfx/core/types/color4.h>
@@ -11,6 +13,21 @@
 namespace gfx::primitives
 {
 
+enum class BitmapFilter
+{
+    NEAREST,
+    BILINEAR
+};
+
+// How minified draws use the mip chain. LINEAR blends the two nearest levels, each
+// sampled bilinearly (trilinear filtering).
+enum class MipmapMode
+{
+    NONE,
+    NEAREST,
+    LINEAR
+};
+
 class Bitmap2D : public gfx::core::Primitive2D
 {
 
@@ -21,49 +38,80 @@ public:
 
     bool point_collides(const gfx::math::Vec2d point, const gfx::math::Matrix3x3d &transform) const override;
 
+    // Copies or moves the bitmap into a buffer of its own.
     inline void load_bitmap(gfx::core::types::Bitmap bitmap)
     {
-        resolution = bitmap.resolution;
-        pixels = bitmap.pixels;
-        set_obb_dirty();
+        share_bitmap(std::make_shared<gfx::core::types::Bitmap>(std::move(bitmap)));
     }
 
+    // Draws straight from a bitmap that other primitives or a producer may also hold. Changes
+    // show up on the next draw once the producer has moved the bitmap to a new version.
+    void share_bitmap(const std::shared_ptr<gfx::core::types::Bitmap> &shared);
+    inline const std::shared_ptr<gfx::core::types::Bitmap> &get_bitmap() const { return bitmap; }
+
     inline gfx::core::types::Color4 get_pixel(const gfx::math::Vec2i pixel) const 
     { 
-        if (pixel.x < 0 || pixel.x >= resolution.x || pixel.y < 0 || pixel.y >= resolution.y) 
+        if (pixel.x < 0 || pixel.x >= bitmap->resolution.x || pixel.y < 0 || pixel.y >= bitmap->resolution.y) 
         {
             return { 0, 0, 0, 0 }; 
         }
-        return pixels[pixel.y * resolution.x + pixel.x]; 
+        return bitmap->at(pixel.x, pixel.y); 
     }
     inline gfx::core::types::Color4 get_pixel(const int x, const int y) const 
     { 
         return get_pixel({ x, y }); 
     }
 
+    // Writes in place. Call get_bitmap()->touch() after a batch of writes so mip levels are
+    // rebuilt from the new pixels.
     inline void set_pixel(const gfx::math::Vec2i pixel, const gfx::core::types::Color4 color) 
     {
-        if (pixel.x < 0 || pixel.x >= resolution.x || pixel.y < 0 || pixel.y >= resolution.y) 
-        {
-            return; 
-        }
-        pixels[pixel.y * resolution.x + pixel.x] = color;
-        set_obb_dirty();
+        bitmap->set_pixel(pixel, color);
     };
 
     inline void set_resolution(const gfx::math::Vec2i new_resolution) 
     { 
-        resolution = new_resolution; 
-        pixels.resize(resolution.x * resolution.y); 
+        bitmap->resize(new_resolution);
         set_obb_dirty();
     }
     inline void set_resolution(const int width, const int height) { set_resolution({ width, height }); }
-    inline gfx::math::Vec2d get_resolution() const { return resolution; }
+    inline gfx::math::Vec2d get_resolution() const { return bitmap->resolution; }
+
+    // Reorders the shared pixels; TILED keeps rotated and minified sampling cache friendly.
+    inline void set_layout(const gfx::core::types::BitmapLayout new_layout) { bitmap->set_layout(new_layout); }
+    inline gfx::core::types::BitmapLayout get_layout() const { return bitmap->layout; }
+
+    inline void set_filter(const BitmapFilter f) { filter = f; }
+    inline BitmapFilter get_filter() const { return filter; }
+
+    // Mip levels come from the bitmap when it has them, otherwise they are built on the first
+    // minified draw after the bitmap changes.
+    inline void set_mipmap_mode(const MipmapMode mode) { mipmap_mode = mode; }
+    inline MipmapMode get_mipmap_mode() const { return mipmap_mode; }
 
 private:
 
-    gfx::math::Vec2i resolution;
-    std::vector<gfx::core::types::Color4> pixels;
+    template <gfx::core::types::BitmapLayout Layout>
+    void rasterize_layout(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+    template <gfx::core::types::BitmapLayout Layout>
+    void rasterize_integer_scaled(const gfx::math::Matrix3x3d &transform, const gfx::math::Box2i &bounds, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+    template <gfx::core::types::BitmapLayout Layout>
+    void rasterize_level(const gfx::math::Matrix3x3d &inverse_transform, const int level, const gfx::math::Box2i &bounds, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+    template <gfx::core::types::BitmapLayout Layout>
+    void rasterize_trilinear(const gfx::math::Matrix3x3d &inverse_transform, const int level, const double blend, const gfx::math::Box2i &bounds, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+
+    void update_geometry() const;
+    const std::vector<gfx::core::types::Bitmap> &get_mipmaps() const;
+    const std::vector<gfx::core::types::Color4> &get_level_pixels(const int level) const;
+    gfx::math::Vec2i get_level_resolution(const int level) const;
+
+    std::shared_ptr<gfx::core::types::Bitmap> bitmap { std::make_shared<gfx::core::types::Bitmap>(gfx::math::Vec2i { 1, 1 }) };
+    mutable gfx::math::Vec2i geometry_resolution { 1, 1 };
+    BitmapFilter filter = BitmapFilter::NEAREST;
+
+    MipmapMode mipmap_mode = MipmapMode::NONE;
+    mutable std::vector<gfx::core::types::Bitmap> mipmaps;
+    mutable uint64_t mipmaps_version = 0;
 };
 
 };
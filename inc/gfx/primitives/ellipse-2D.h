@@ -36,8 +36,6 @@ private:
     gfx::math::Vec2d radius;
     double line_thickness = 1.0;
     bool filled = false;
-    
-    double MIN_MULTITHREAD_PIXELS { 100 * 100 };
 };
 
 };
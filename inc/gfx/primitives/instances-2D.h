@@ -0,0 +1,73 @@
+#ifndef INSTANCES_2D_H
+#define INSTANCES_2D_H
+
+#include <memory>
+#include <span>
+#include <vector>
+#include <gfx/core/primitive-2D.h>
+#include <gfx/core/types/color4.h>
+#include <gfx/math/box2.h>
+#include <gfx/math/vec2.h>
+#include <gfx/math/matrix.h>
+
+namespace gfx::primitives
+{
+
+struct Instance2D
+{
+    gfx::math::Vec2d position;
+    double rotation = 0.0;
+    gfx::math::Vec2d scale { 1.0, 1.0 };
+    gfx::core::types::Color4 color { 1.0, 1.0, 1.0 };
+    int depth = 0;
+};
+
+// Draws one template primitive many times from a contiguous instance array, as a single
+// scene node. Each instance places the template with its own position, rotation and scale
+// around the template's anchor, and replaces its color. The template's own position,
+// rotation and scale are ignored, and instances are ordered by depth among themselves only.
+class Instances2D : public gfx::core::Primitive2D
+{
+
+public:
+
+    void rasterize(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const override;
+    gfx::math::Box2d get_geometry_size() const override;
+
+    bool point_collides(const gfx::math::Vec2d point, const gfx::math::Matrix3x3d &transform) const override;
+
+    gfx::math::Matrix3x3d get_instance_transform(const Instance2D &instance) const;
+
+    inline void set_template(const std::shared_ptr<gfx::core::Primitive2D> primitive) { prototype = primitive; set_instances_dirty(); }
+    inline std::shared_ptr<gfx::core::Primitive2D> get_template() const { return prototype; }
+
+    inline void add_instance(const Instance2D &instance) { instances.push_back(instance); set_instances_dirty(); }
+    inline void set_instances(std::vector<Instance2D> &&new_instances) { instances = std::move(new_instances); set_instances_dirty(); }
+    inline void resize_instances(const size_t count) { instances.resize(count); set_instances_dirty(); }
+    inline void clear_instances() { instances.clear(); set_instances_dirty(); }
+
+    // Bulk access for in-place updates; the bounds and depth order are rebuilt on the next use.
+    inline std::span<Instance2D> edit_instances() { set_instances_dirty(); return instances; }
+    inline std::span<const Instance2D> get_instances() const { return instances; }
+    inline size_t get_num_instances() const { return instances.size(); }
+
+private:
+
+    inline void set_instances_dirty() { bounds_dirty = true; order_dirty = true; set_obb_dirty(); }
+
+    gfx::math::Vec2d get_anchor_offset() const;
+    static gfx::math::Matrix3x3d get_instance_transform(const Instance2D &instance, const gfx::math::Vec2d anchor_offset);
+
+    std::shared_ptr<gfx::core::Primitive2D> prototype;
+    std::vector<Instance2D> instances;
+
+    mutable std::vector<size_t> draw_order;
+    mutable bool order_dirty = true;
+
+    mutable gfx::math::Box2d cached_bounds;
+    mutable bool bounds_dirty = true;
+};
+
+};
+
+#endif // INSTANCES_2D_H
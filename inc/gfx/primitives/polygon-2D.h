@@ -8,6 +8,8 @@
 #include <gfx/math/matrix.h>
 #include <gfx/geometry/triangle.h>
 #include <gfx/geometry/types/polygon.h>
+#include <gfx/geometry/triangulate.h>
+#include <gfx/geometry/scanline.h>
 
 namespace gfx::primitives
 {
@@ -17,6 +19,12 @@ class Polygon2D : public gfx::core::Primitive2D
 
 public:
 
+    enum class FillMethod
+    {
+        SCANLINE,
+        TRIANGLES
+    };
+
     void rasterize(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const override;
     gfx::math::Box2d get_geometry_size() const override;
 
@@ -42,14 +50,42 @@ public:
 
     std::vector<gfx::math::Vec2d> get_hole_vertices(const int component = 0, const int hole = 0) const;
 
+    inline void set_fill_rule(const gfx::geometry::FillRule rule) { fill_rule = rule; }
+    inline gfx::geometry::FillRule get_fill_rule() const { return fill_rule; }
+
+    inline void set_fill_method(const FillMethod method) { fill_method = method; }
+    inline FillMethod get_fill_method() const { return fill_method; }
+
 
 private:
 
+    void ensure_component(const int component);
+    void ensure_hole(const int component, const int hole);
+
     bool cache_clockwise(const int component);
     bool cache_clockwise_hole(const int component, const int hole);
-    void rasterize_component(const gfx::geometry::types::Component &component, const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+    void rasterize_component(const gfx::geometry::Triangulation &triangulation, const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+
+    void rasterize_component_scanline(const gfx::geometry::types::Component &component, const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+
+    const gfx::geometry::Triangulation &get_triangulation(const int component) const;
+    inline void set_triangulation_dirty(const int component)
+    {
+        if (static_cast<std::size_t>(component) < triangulations_dirty.size())
+        {
+            triangulations_dirty[component] = true;
+        }
+    }
 
     std::vector<gfx::geometry::types::Component> components;
+
+    gfx::geometry::FillRule fill_rule = gfx::geometry::FillRule::EVEN_ODD;
+    FillMethod fill_method = FillMethod::SCANLINE;
+
+    // One triangulation per component, rebuilt only for components that changed. Components
+    // added since the last lookup start out dirty.
+    mutable std::vector<gfx::geometry::Triangulation> cached_triangulations;
+    mutable std::vector<bool> triangulations_dirty;
     static constexpr int CORNER_SEGMENTS = 8;
 };
 
@@ -1,11 +1,15 @@
 #ifndef POLYLINE_2D_H
 #define POLYLINE_2D_H
 
+#include <deque>
 #include <gfx/core/primitive-2D.h>
 #include <gfx/math/box2.h>
 #include <gfx/math/vec2.h>
 #include <gfx/math/matrix.h>
 #include <gfx/geometry/triangle.h>
+#include <gfx/geometry/triangulate.h>
+#include <gfx/geometry/stroke.h>
+#include <gfx/geometry/types/edge.h>
 
 namespace gfx::primitives
 {
@@ -21,91 +25,140 @@ public:
 
     bool point_collides(const gfx::math::Vec2d point, const gfx::math::Matrix3x3d &transform) const override;
 
-    bool cache_clockwise();
+    bool cache_clockwise() const;
 
-    inline void add_point(const gfx::math::Vec2d point) { points.push_back(point); cache_clockwise(); set_obb_dirty(); }
-    inline void add_point(const double x, const double y) { points.push_back(gfx::math::Vec2d { x, y }); cache_clockwise(); set_obb_dirty(); }
-    inline void add_points(const std::vector<gfx::math::Vec2d> &new_points) { points.insert(points.end(), new_points.begin(), new_points.end()); cache_clockwise(); set_obb_dirty(); }
+    inline void add_point(const gfx::math::Vec2d point) { push_point(point); }
+    inline void add_point(const double x, const double y) { push_point(gfx::math::Vec2d { x, y }); }
+    void add_points(const std::vector<gfx::math::Vec2d> &new_points);
 
-    inline void set_point(const size_t index, const gfx::math::Vec2d point) 
-    { 
-        if (index < points.size()) 
-        { 
-            points[index] = point; 
-            cache_clockwise();
-            set_obb_dirty();
-        } 
-    }
-    inline void set_point(const size_t index, const double x, const double y) 
-    { 
-        if (index < points.size()) 
-        { 
-            points[index] = gfx::math::Vec2d { x, y }; 
-            cache_clockwise();
-            set_obb_dirty();
-        } 
-    }
-    inline void set_points(const std::vector<gfx::math::Vec2d> &new_points) { points = new_points; cache_clockwise(); set_obb_dirty(); }
-    inline void clear_points() { points.clear(); }
-
-    inline void set_segment_visible(const size_t index, const bool visible) 
-    { 
-        if (segments_visible.size() < points.size()) 
-        { 
-            segments_visible.resize(points.size(), true); 
+    // Streaming updates: only the segments touching the added or removed point are restroked.
+    // With a point limit set, push_point drops the oldest point once the limit is reached.
+    void push_point(const gfx::math::Vec2d point);
+    inline void push_point(const double x, const double y) { push_point(gfx::math::Vec2d { x, y }); }
+    void pop_front();
+
+    inline void set_max_points(const size_t max) { max_points = max; }
+    inline size_t get_max_points() const { return max_points; }
+
+    void set_point(const size_t index, const gfx::math::Vec2d point);
+    inline void set_point(const size_t index, const double x, const double y) { set_point(index, gfx::math::Vec2d { x, y }); }
+    void set_points(const std::vector<gfx::math::Vec2d> &new_points);
+    void clear_points();
+
+    inline void set_segment_visible(const size_t index, const bool visible)
+    {
+        if (segments_visible.size() < points.size())
+        {
+            segments_visible.resize(points.size(), true);
+        }
+        if (index < points.size())
+        {
+            segments_visible[index] = visible;
+            set_simplified_dirty();
         }
-        if (index < points.size()) 
-        { 
-            segments_visible[index] = visible; 
-        } 
     }
-    inline bool get_segment_visible(const size_t index) const 
-    { 
-        if (index < points.size()) 
-        { 
-            return segments_visible[index]; 
-        } 
-        return false; 
+    inline bool get_segment_visible(const size_t index) const
+    {
+        if (index < points.size())
+        {
+            return index >= segments_visible.size() || segments_visible[index];
+        }
+        return false;
     }
 
-    inline const std::vector<gfx::math::Vec2d> get_points() const { return points; }
-    inline gfx::math::Vec2d get_point(const size_t index) const 
-    { 
-        if (index < points.size()) 
-        { 
-            return points[index]; 
-        } 
-        return gfx::math::Vec2d::zero(); 
+    inline const std::vector<gfx::math::Vec2d> get_points() const { return { points.begin(), points.end() }; }
+    inline gfx::math::Vec2d get_point(const size_t index) const
+    {
+        if (index < points.size())
+        {
+            return points[index];
+        }
+        return gfx::math::Vec2d::zero();
     }
 
     inline size_t get_num_points() const { return points.size(); }
 
-    inline void set_close(const bool close) { do_close = close; }
+    inline void set_close(const bool close) { do_close = close; set_simplified_dirty(); }
     inline bool get_close() const { return do_close; }
 
-    inline void set_rounded_corners(const bool rounded) { do_rounded_corners = rounded; set_obb_dirty(); }
-    inline bool get_rounded_corners() const { return do_rounded_corners; }
+    inline void set_rounded_corners(const bool rounded)
+    {
+        stroke_style.join = rounded ? gfx::geometry::LineJoin::ROUND : gfx::geometry::LineJoin::MITER;
+        stroke_style.cap = rounded ? gfx::geometry::LineCap::ROUND : gfx::geometry::LineCap::BUTT;
+        set_stroke_dirty();
+        set_obb_dirty();
+    }
+    inline bool get_rounded_corners() const { return stroke_style.join == gfx::geometry::LineJoin::ROUND; }
+
+    inline void set_line_join(const gfx::geometry::LineJoin join) { stroke_style.join = join; set_stroke_dirty(); set_obb_dirty(); }
+    inline gfx::geometry::LineJoin get_line_join() const { return stroke_style.join; }
+
+    inline void set_line_cap(const gfx::geometry::LineCap cap) { stroke_style.cap = cap; set_simplified_dirty(); set_obb_dirty(); }
+    inline gfx::geometry::LineCap get_line_cap() const { return stroke_style.cap; }
+
+    inline void set_miter_limit(const double limit) { stroke_style.miter_limit = limit; set_stroke_dirty(); set_obb_dirty(); }
+    inline double get_miter_limit() const { return stroke_style.miter_limit; }
 
-    inline void set_line_thickness(const double t) { line_thickness = t; set_obb_dirty(); }
-    inline double get_line_thickness() const { return line_thickness; }
+    inline void set_line_thickness(const double t)
+    {
+        if (t != stroke_style.width)
+        {
+            stroke_style.width = t;
+            set_stroke_dirty();
+            set_obb_dirty();
+        }
+    }
+    inline double get_line_thickness() const { return stroke_style.width; }
 
     inline void set_fill(const bool f) { do_fill = f; }
     inline bool get_fill() const { return do_fill; }
 
-private:
+    // Screen-space simplification tolerance in pixels; 0 strokes every segment. Points closer
+    // than the tolerance to the simplified path are dropped after the transform is applied.
+    inline void set_simplify_tolerance(const double tolerance) { simplify_tolerance = tolerance; set_simplified_dirty(); }
+    inline double get_simplify_tolerance() const { return simplify_tolerance; }
 
-    void rasterize_rounded_corners(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
-    void rasterize_rounded_corner(const gfx::math::Vec2d pos, const double angle0, const double angle1, const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
-    void rasterize_edge(const gfx::math::Vec2d start, const gfx::math::Vec2d end, const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+private:
 
-    std::vector<gfx::math::Vec2d> points;
-    std::vector<bool> segments_visible;
+    // Stroke geometry of the segment starting at a point, plus the join at that point.
+    struct SegmentStroke
+    {
+        std::vector<gfx::geometry::types::Edge> body;
+        std::vector<gfx::geometry::types::Edge> join;
+        bool valid = false;
+    };
+
+    void rasterize_stroke(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+    void build_segment_stroke(const size_t index, const gfx::geometry::StrokeStyle &style) const;
+    void rasterize_simplified(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+    void build_simplified_stroke(const gfx::math::Matrix3x3d &transform) const;
+    void rasterize_fill(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+
+    void invalidate_segment(const size_t index);
+    void invalidate_repeated_segments(const size_t first);
+    inline void set_stroke_dirty() { stroke_dirty = true; simplified_dirty = true; }
+    inline void set_fill_dirty() { fill_dirty = true; simplified_dirty = true; }
+    inline void set_simplified_dirty() { simplified_dirty = true; }
+
+    std::deque<gfx::math::Vec2d> points;
+    std::deque<bool> segments_visible;
+    size_t max_points = 0;
     bool do_close = false;
     bool do_fill = false;
-    double line_thickness = 1.0;
-    bool do_rounded_corners = false;
-    bool clockwise = false;
-    static constexpr int CORNER_SEGMENTS = 8;
+    gfx::geometry::StrokeStyle stroke_style;
+
+    mutable bool clockwise = false;
+    mutable gfx::geometry::Triangulation cached_fill;
+    mutable bool fill_dirty = true;
+
+    mutable std::deque<SegmentStroke> segment_strokes;
+    mutable double cached_stroke_tolerance = 0.0;
+    mutable bool stroke_dirty = true;
+
+    double simplify_tolerance = 0.0;
+    mutable std::vector<gfx::geometry::types::Edge> cached_simplified_edges;
+    mutable gfx::math::Matrix3x3d cached_simplified_transform;
+    mutable bool simplified_dirty = true;
 };
 
 };
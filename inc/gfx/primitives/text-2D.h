@@ -19,6 +19,12 @@ public:
         RIGHT
     };
 
+    enum class RenderMode
+    {
+        FILL,
+        SDF
+    };
+
     void rasterize(const gfx::math::Matrix3x3d &transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const override;
     gfx::math::Box2d get_geometry_size() const override;
     bool point_collides(const gfx::math::Vec2d point, const gfx::math::Matrix3x3d &transform) const override { return false; }
@@ -52,6 +58,9 @@ public:
 
     TextAlignment get_alignment() const { return alignment; }
 
+    inline void set_render_mode(const RenderMode mode) { render_mode = mode; }
+    inline RenderMode get_render_mode() const { return render_mode; }
+
     inline void set_line_height_multiplier(const double multiplier) 
     { 
         line_height_multiplier = multiplier; 
@@ -62,12 +71,15 @@ public:
 
 private:
 
-    void rasterize_glyph(std::vector<gfx::text::ContourEdge> glyph, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+    void rasterize_glyph_sdf(const gfx::text::GlyphSDF &sdf, const gfx::math::Matrix3x3d &glyph_transform, const std::function<void(const gfx::core::types::Pixel&)> emit_pixel) const;
+
+    int get_lod_level() const;
 
     void set_edges_dirty() { edges_dirty = true; }
     void set_size_dirty() { size_dirty = true; }
 
     TextAlignment alignment = TextAlignment::LEFT;
+    RenderMode render_mode = RenderMode::FILL;
 
     gfx::math::Vec2d text_box { -1.0, -1.0 };
 
@@ -80,6 +92,10 @@ private:
     mutable bool edges_dirty = true;
     mutable bool size_dirty = true;
 
+    // Largest axis scale of the last draw transform, so bounds are measured on the outlines
+    // the draw flattened. Negative until the first draw.
+    mutable double lod_scale = -1.0;
+
     mutable gfx::math::Box2d cached_geometry_size;
     mutable std::unordered_map<uint32_t, std::vector<gfx::text::ContourEdge>> cached_glyph_edges;
  };
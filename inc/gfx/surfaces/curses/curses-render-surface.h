@@ -1,26 +1,42 @@
 #ifndef CURSES_RENDER_SURFACE_H
 #define CURSES_RENDER_SURFACE_H
 
+#include <string>
+#include <vector>
 #include <string_view>
 #include <ncurses.h>
 #include <gfx/core/render-surface.h>
+#include <gfx/math/box2.h>
 
 namespace gfx::surfaces
 {
 
+// PALETTE draws 2x2 dots per cell in curses color pairs. TRUECOLOR uses all 2x4 braille dots
+// and writes 24-bit color escapes straight to the terminal, so curses is left with input only.
+enum class CursesSurfaceMode
+{
+    PALETTE,
+    TRUECOLOR
+};
+
 class CursesRenderSurface : public gfx::core::RenderSurface
 {
 
 public:
 
-    CursesRenderSurface(const gfx::math::Vec2i resolution) 
+    CursesRenderSurface(const gfx::math::Vec2i resolution, const CursesSurfaceMode mode = CursesSurfaceMode::PALETTE) 
         : RenderSurface(resolution), 
-        palette(std::make_unique<std::unordered_map<gfx::core::types::Color4, uint8_t, std::hash<gfx::core::types::Color4>>>()), 
-        frame_buffer(std::make_unique<std::vector<int64_t>>(resolution.x * resolution.y / 2, 0))
-        {};
+        mode(mode),
+        frame_buffer(std::make_unique<std::vector<int64_t>>()),
+        palette(std::make_unique<std::unordered_map<gfx::core::types::Color4, uint8_t, std::hash<gfx::core::types::Color4>>>())
+    {
+        resize(resolution);
+    };
 
     int init() override;
 
+    // Composes cells from the pixels, then writes only cells whose glyph or color changed since
+    // the last present, one run of same-colored cells at a time.
     void present() override;
     void clear() const override;
 
@@ -31,18 +47,81 @@ public:
 
     void clear_palette() override;
 
+    inline CursesSurfaceMode get_mode() const { return mode; }
+
+    // Pixels per terminal cell.
+    static inline gfx::math::Vec2i get_cell_size(const CursesSurfaceMode mode) 
+    { 
+        return mode == CursesSurfaceMode::TRUECOLOR ? gfx::math::Vec2i { 2, 4 } : gfx::math::Vec2i { 2, 2 }; 
+    }
+    inline gfx::math::Vec2i get_cell_size() const { return get_cell_size(mode); }
+    inline gfx::math::Vec2i get_cell_dimensions() const { return resolution / get_cell_size(); }
+
+    // Places text over the cells of the next present only. Coordinates are in terminal cells.
+    void draw_text(const gfx::math::Vec2i cell, const std::string_view text, const gfx::core::types::Color4 color);
+
+    // Forces cells to be written on the next present, for when something else has drawn over
+    // them. Coordinates are in terminal cells.
+    void invalidate();
+    void invalidate(const gfx::math::Box2i cells);
+
+    // Invalidates the cells under lines of text written through curses from `cell` down, so
+    // they are repainted once the text shrinks or is hidden.
+    void invalidate_text(const gfx::math::Vec2i cell, const std::vector<std::string> &lines);
+
 private:
 
+    struct TextOverlay
+    {
+        gfx::math::Vec2i cell;
+        std::string text;
+        gfx::core::types::Color4 color;
+    };
+
+    // Turns each block of pixels into a cell, splitting rows of cells across threads. A cell
+    // takes the color most of its lit pixels share.
     void render_multithreaded();
+    template <int CellHeight>
+    void compose_rows(const int start_y, const int end_y);
+    void compose_text();
+
+    void present_palette();
+    void present_truecolor();
+    void append_glyph(std::string &text, const int64_t cell) const;
+
     void set_color(const gfx::core::types::Color4 color);
     uint8_t add_color(const gfx::core::types::Color4 color);
 
+    static int64_t visible_cell(const int64_t cell);
+
+    CursesSurfaceMode mode;
+
+    // One cell per block of pixels: color in the high 32 bits, then either braille dots in the
+    // low byte or, with TEXT_CELL set, a character in the byte above.
+    static constexpr int64_t TEXT_CELL { 1 << 16 };
     std::unique_ptr<std::vector<int64_t>> frame_buffer;
+    std::vector<gfx::core::types::Color4> pixels;
+    std::vector<TextOverlay> text_overlays;
+
+    // What the terminal shows for each frame buffer cell, with blank cells stored as 0.
+    static constexpr int64_t INVALID_CELL { -1 };
+    std::vector<int64_t> presented_cells;
+    std::string run_text;
+    bool needs_erase = true;
 
     std::unique_ptr<std::unordered_map<gfx::core::types::Color4, uint8_t, std::hash<gfx::core::types::Color4>>> palette;
     int color_index = 0;
 
+    // The color held by each dedicated color number, and the colors whose numbers were
+    // redefined during the current present. Cells still showing those are repainted.
+    std::vector<gfx::core::types::Color4> slot_colors;
+    std::vector<int64_t> evicted_colors;
+
+    // TRUECOLOR output is gathered here and written to the terminal in one go.
+    std::string output_buffer;
+
     static constexpr uint8_t DEDICATED_CURSES_COLOR_START_INDEX = 127;
+    static constexpr int MIN_MULTITHREAD_CELLS { 256 * 64 };
 
     static constexpr std::string_view pixel_tree[2][2][2][2] {
         { // TOP LEFT 0
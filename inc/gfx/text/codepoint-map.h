@@ -0,0 +1,83 @@
+#ifndef CODEPOINT_MAP_H
+#define CODEPOINT_MAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gfx::text
+{
+
+class CodepointMap
+{
+
+public:
+
+    static constexpr uint32_t MAX_CODEPOINT { 0x10FFFF };
+    static constexpr int PAGE_BITS { 8 };
+    static constexpr uint32_t PAGE_SIZE { 1u << PAGE_BITS };
+    static constexpr uint32_t NUM_PAGES { (MAX_CODEPOINT + 1) >> PAGE_BITS };
+
+    using Page = std::array<uint16_t, PAGE_SIZE>;
+
+    CodepointMap() : page_index(NUM_PAGES, 0), pages(1)
+    {
+        pages[0].fill(0);
+    }
+
+    CodepointMap(std::vector<uint16_t> &&page_index, std::vector<Page> &&pages)
+        : page_index(std::move(page_index)), pages(std::move(pages)) {}
+
+    inline uint16_t get(const uint32_t codepoint) const
+    {
+        if (codepoint > MAX_CODEPOINT)
+        {
+            return 0;
+        }
+        return pages[page_index[codepoint >> PAGE_BITS]][codepoint & (PAGE_SIZE - 1)];
+    }
+
+    inline void set(const uint32_t codepoint, const uint16_t glyph_index)
+    {
+        if (codepoint > MAX_CODEPOINT)
+        {
+            return;
+        }
+
+        uint16_t &page { page_index[codepoint >> PAGE_BITS] };
+        if (page == 0)
+        {
+            if (glyph_index == 0)
+            {
+                return;
+            }
+            page = static_cast<uint16_t>(pages.size());
+            pages.emplace_back().fill(0);
+        }
+        pages[page][codepoint & (PAGE_SIZE - 1)] = glyph_index;
+    }
+
+    inline bool contains(const uint32_t codepoint) const { return get(codepoint) != 0; }
+
+    inline std::size_t num_pages() const { return pages.size() - 1; }
+
+    inline const std::vector<uint16_t> &get_page_index() const { return page_index; }
+    inline const std::vector<Page> &get_pages() const { return pages; }
+
+    inline void clear()
+    {
+        std::fill(page_index.begin(), page_index.end(), 0);
+        pages.resize(1);
+    }
+
+private:
+
+    std::vector<uint16_t> page_index;
+    std::vector<Page> pages;
+};
+
+}
+
+#endif // CODEPOINT_MAP_H
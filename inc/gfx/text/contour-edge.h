@@ -0,0 +1,13 @@
+#ifndef CONTOUR_EDGE_H
+#define CONTOUR_EDGE_H
+
+#include <gfx/geometry/types/edge.h>
+
+namespace gfx::text
+{
+
+using ContourEdge = gfx::geometry::types::Edge;
+
+}
+
+#endif // CONTOUR_EDGE_H
@@ -0,0 +1,22 @@
+#ifndef FONT_BUNDLE_H
+#define FONT_BUNDLE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <gfx/text/font-ttf.h>
+
+namespace gfx::text
+{
+
+static constexpr uint32_t FONT_BUNDLE_MAGIC { 0x42584647 }; // "GFXB"
+static constexpr uint32_t FONT_BUNDLE_VERSION { 2 };
+
+uint64_t compute_font_checksum(const uint8_t* data, const std::size_t size);
+
+void write_font_bundle(const FontTTF &font, const uint64_t source_checksum, const std::filesystem::path &path);
+std::shared_ptr<FontTTF> load_font_bundle(const std::filesystem::path &path, const uint64_t source_checksum);
+
+}
+
+#endif // FONT_BUNDLE_H
@@ -1,6 +1,7 @@
 #ifndef FONT_MANAGER_TTF_H
 #define FONT_MANAGER_TTF_H
 
+#include <algorithm>
 #include <filesystem>
 #include <gfx/text/font-manager.h>
 #include <gfx/text/font-ttf.h>
@@ -8,6 +9,31 @@
 namespace gfx::text
 {
 
+struct FontLoadReport
+{
+    std::string name;
+    std::filesystem::path path;
+    double load_time_ms = 0.0;
+    std::size_t bytes_mapped = 0;
+    int num_glyphs = 0;
+    bool from_bundle = false;
+    std::string error;
+
+    inline bool loaded() const { return error.empty(); }
+};
+
+struct FontDirectoryReport
+{
+    std::vector<FontLoadReport> fonts;
+    double total_time_ms = 0.0;
+    unsigned int num_threads = 0;
+
+    inline int num_loaded() const
+    {
+        return static_cast<int>(std::count_if(fonts.begin(), fonts.end(), [](const FontLoadReport &report) { return report.loaded(); }));
+    }
+};
+
 class FontManagerTTF
 {
 
@@ -16,7 +42,7 @@ public:
     std::shared_ptr<FontTTF> load_from_file(const std::string &path, const std::string &name = "");
     std::shared_ptr<FontTTF> load_from_memory(const uint8_t* data, const std::size_t size, const std::string &name);
 
-    void load_font_directory(const std::filesystem::path &path = "");
+    FontDirectoryReport load_font_directory(const std::filesystem::path &path = "");
 
     std::unordered_map<std::string, std::shared_ptr<FontTTF>> get_loaded_fonts() const
     {
@@ -63,14 +89,32 @@ public:
         return font_directory_path;
     }
 
+    void set_bundle_directory_path(const std::filesystem::path &path)
+    {
+        bundle_directory_path = path;
+    }
+
+    std::filesystem::path get_bundle_directory_path() const
+    {
+        return bundle_directory_path;
+    }
+
 
 private:
 
-    std::unordered_map<uint32_t, uint16_t> parse_cmap_format_4(const std::uint8_t* cmap_table, const uint32_t length);
+    std::shared_ptr<FontTTF> parse_font(const uint8_t* data, const std::size_t size, const std::string &name);
+    std::shared_ptr<FontTTF> parse_font_file(const std::filesystem::path &path, const std::string &name, FontLoadReport &report);
+
+    void parse_cmap_format_4(const std::uint8_t* cmap_table, const std::uint8_t* cmap_end, CodepointMap &codepoint_map);
+    void parse_cmap_format_12(const std::uint8_t* cmap_table, const std::uint8_t* cmap_end, CodepointMap &codepoint_map);
+    void parse_kern_table(const std::uint8_t* kern_table, const std::uint8_t* kern_end, KerningTable &kerning);
+    void parse_gpos_table(const std::uint8_t* gpos_table, const std::uint8_t* gpos_end, const uint16_t num_glyphs, KerningTable &kerning);
     std::vector<uint32_t> parse_loca_table(const std::uint8_t* loca_table, const uint16_t num_glyphs, uint16_t index_to_loc_format);
+    void parse_composite_glyph(const std::uint8_t* ptr, const std::uint8_t* glyph_end, GlyphTTF &glyph);
     std::shared_ptr<GlyphTTF> parse_glyph(const std::uint8_t* glyf_table, const std::vector<uint32_t> &glyph_offsets, const uint16_t glyph_index, bool loca_long_format);
 
     std::filesystem::path font_directory_path;
+    std::filesystem::path bundle_directory_path;
 
     std::unordered_map<std::string, std::shared_ptr<FontTTF>> loaded_fonts;
 };
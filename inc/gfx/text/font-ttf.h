@@ -1,11 +1,20 @@
 #ifndef FONT_TTF_H
 #define FONT_TTF_H
 
+#include <array>
 #include <string>
 #include <vector>
+#include <memory>
+#include <span>
 #include <unordered_map>
 #include <gfx/text/font.h>
+#include <gfx/text/contour-edge.h>
+#include <gfx/text/glyph-sdf.h>
+#include <gfx/text/codepoint-map.h>
+#include <gfx/text/kerning-table.h>
 #include <gfx/math/box2.h>
+#include <gfx/math/matrix.h>
+#include <gfx/utils/mapped-file.h>
 
 namespace gfx::text
 {
@@ -17,16 +26,25 @@ struct Point
     bool on_curve;
 };
 
+struct GlyphComponent
+{
+    uint16_t glyph_index;
+    gfx::math::Matrix3x3d transform;
+};
+
 struct GlyphTTF
 {
     gfx::math::Box2d bbox;
     std::vector<std::vector<Point>> contours;
+    std::vector<GlyphComponent> components;
+
+    inline bool is_composite() const { return !components.empty(); }
 };
 
-struct ContourEdge
+struct GlyphEdgeRange
 {
-    gfx::math::Vec2d v0;
-    gfx::math::Vec2d v1;
+    uint32_t offset;
+    uint32_t count;
 };
 
 struct GlyphMetrics
@@ -43,32 +61,63 @@ public:
     FontTTF(int units_per_em, double ascent, double descent, double line_gap, int num_glyphs)
         : units_per_em(units_per_em), ascent(ascent), descent(descent), line_gap(line_gap), num_glyphs(num_glyphs) {}
 
+    inline uint16_t get_glyph_index(const uint32_t codepoint) const { return codepoint_map.get(codepoint); }
+    inline bool has_glyph(const uint32_t codepoint) const { return codepoint_map.contains(codepoint); }
+
     std::shared_ptr<GlyphTTF> get_glyph(const uint32_t codepoint) const;
+    std::shared_ptr<GlyphTTF> get_glyph_by_index(const uint16_t glyph_index) const;
+
+    static constexpr int NUM_LOD_LEVELS { 10 };
+    static constexpr int DEFAULT_LOD_LEVEL { 2 };
+    static constexpr double BASE_LOD_TOLERANCE { 0.125 };
+    static constexpr double PIXEL_TOLERANCE { 0.25 };
+
+    int get_lod_level(const double pixel_size) const;
+    static inline double get_lod_tolerance(const int lod_level) { return BASE_LOD_TOLERANCE * (1 << lod_level); }
 
-    std::vector<ContourEdge> get_glyph_edges(const uint32_t codepoint) const;
+    std::vector<ContourEdge> get_glyph_edges(const uint32_t codepoint, const int lod_level = DEFAULT_LOD_LEVEL) const;
+    std::span<const ContourEdge> get_glyph_edges_by_index(const uint16_t glyph_index, const int lod_level = DEFAULT_LOD_LEVEL) const;
 
-    void set_kerning(const char left, const char right, const int offset)
+    void set_mapped_edges(const int lod_level, std::span<const GlyphEdgeRange> ranges, std::span<const ContourEdge> edges);
+    void set_mapped_storage(const std::shared_ptr<const utils::MappedFile> storage) { mapped_storage = storage; }
+    inline bool has_mapped_edges(const int lod_level) const { return !mapped_edges[lod_level].ranges.empty(); }
+
+    static constexpr double SDF_TEXELS_PER_EM { 48.0 };
+    static constexpr double SDF_SPREAD_TEXELS { 4.0 };
+
+    const GlyphSDF &get_glyph_sdf_by_index(const uint16_t glyph_index) const;
+
+    void set_kerning_table(KerningTable &&table) { kerning_table = std::move(table); }
+    const KerningTable &get_kerning_table() const { return kerning_table; }
+
+    inline int get_kerning(const uint32_t left, const uint32_t right) const
     {
-        kerning_table[{static_cast<uint32_t>(static_cast<uint8_t>(left)), static_cast<uint32_t>(static_cast<uint8_t>(right))}] = offset;
+        return get_kerning_by_index(get_glyph_index(left), get_glyph_index(right));
     }
-    int get_kerning(const char left, const char right) const
+    inline int get_kerning_by_index(const uint16_t left, const uint16_t right) const
     {
-        return kerning_table.count({static_cast<uint32_t>(static_cast<uint8_t>(left)), static_cast<uint32_t>(static_cast<uint8_t>(right))}) ?
-            kerning_table.at({static_cast<uint32_t>(static_cast<uint8_t>(left)), static_cast<uint32_t>(static_cast<uint8_t>(right))}) : 0;
+        return kerning_table.get(left, right);
     }
 
-    void set_metrics(const uint32_t codepoint, const GlyphMetrics &metrics)
+    void set_metrics(const std::vector<GlyphMetrics> &metrics) { glyph_metrics = metrics; }
+    const std::vector<GlyphMetrics> &get_metrics() const { return glyph_metrics; }
+
+    inline int get_glyph_advance(const uint32_t codepoint) const
+    {
+        return get_glyph_advance_by_index(get_glyph_index(codepoint));
+    }
+    inline int get_glyph_left_side_bearing(const uint32_t codepoint) const
     {
-        glyph_metrics[codepoint] = metrics;
+        return get_glyph_left_side_bearing_by_index(get_glyph_index(codepoint));
     }
 
-    int get_glyph_advance(const uint32_t codepoint) const
+    inline int get_glyph_advance_by_index(const uint16_t glyph_index) const
     {
-        return glyph_metrics.count(codepoint) ? glyph_metrics.at(codepoint).advance_width : 0;
+        return glyph_index != 0 && glyph_index < glyph_metrics.size() ? glyph_metrics[glyph_index].advance_width : 0;
     }
-    int get_glyph_left_side_bearing(const uint32_t codepoint) const
+    inline int get_glyph_left_side_bearing_by_index(const uint16_t glyph_index) const
     {
-        return glyph_metrics.count(codepoint) ? glyph_metrics.at(codepoint).left_side_bearing : 0;
+        return glyph_index != 0 && glyph_index < glyph_metrics.size() ? glyph_metrics[glyph_index].left_side_bearing : 0;
     }
 
     double get_ascent() const { return ascent; }
@@ -76,16 +125,44 @@ public:
     double get_line_gap() const { return line_gap; }
     double get_line_height() const { return ascent - descent + line_gap; }
     double get_units_per_em() const { return units_per_em; }
+    int get_num_glyphs() const { return num_glyphs; }
 
     inline void set_name(const std::string &n) { name = n; }
     inline std::string get_name() const { return name; }
 
-    void set_glyphs(const std::unordered_map<uint32_t, std::shared_ptr<GlyphTTF>> &g) { glyphs = g; }
-    std::unordered_map<uint32_t, std::shared_ptr<GlyphTTF>> get_glyphs() const { return glyphs; }
+    void set_glyphs(const std::vector<std::shared_ptr<GlyphTTF>> &g) 
+    { 
+        glyphs = g; 
+        for (auto &cache : edge_caches)
+        {
+            cache.edges.clear();
+            cache.valid.clear();
+        }
+        sdf_cache.clear();
+        sdf_cache_valid.clear();
+    }
+    const std::vector<std::shared_ptr<GlyphTTF>> &get_glyphs() const { return glyphs; }
+
+    void set_codepoint_map(CodepointMap &&map) { codepoint_map = std::move(map); }
+    const CodepointMap &get_codepoint_map() const { return codepoint_map; }
 
 private:
 
-    std::vector<ContourEdge> flatten_glyph(const std::shared_ptr<GlyphTTF> glyph) const;
+    struct EdgeCache
+    {
+        std::vector<std::vector<ContourEdge>> edges;
+        std::vector<bool> valid;
+    };
+
+    struct MappedEdges
+    {
+        std::span<const GlyphEdgeRange> ranges;
+        std::span<const ContourEdge> edges;
+    };
+
+    int resolve_lod_level(const int lod_level) const;
+    std::span<const ContourEdge> get_cached_glyph_edges(const uint16_t glyph_index, const int lod_level, const int depth) const;
+    std::vector<ContourEdge> flatten_glyph(const std::shared_ptr<GlyphTTF> glyph, const int lod_level, const int depth) const;
     bool decode_utf8(const std::string &s, size_t pos, uint32_t &out_codepoint, size_t &bytes) const;
 
     std::string name;
@@ -96,18 +173,18 @@ private:
     double line_gap;
     int num_glyphs;
 
-    struct PairHash {
-        std::size_t operator()(const std::pair<int,int>& p) const 
-        {
-            return std::hash<int>()(p.first) ^ (std::hash<int>()(p.second) << 1);
-        }
-    };
+    static constexpr int MAX_COMPONENT_DEPTH { 8 };
 
-    std::unordered_map<uint32_t, std::shared_ptr<GlyphTTF>> glyphs;
-    std::unordered_map<uint32_t, GlyphMetrics> glyph_metrics;
-    std::unordered_map<std::pair<uint32_t, uint32_t>, int, PairHash> kerning_table;
+    CodepointMap codepoint_map;
+    std::vector<std::shared_ptr<GlyphTTF>> glyphs;
+    std::vector<GlyphMetrics> glyph_metrics;
+    KerningTable kerning_table;
 
-    mutable std::unordered_map<uint32_t, std::vector<ContourEdge>> vertex_cache;
+    mutable std::array<EdgeCache, NUM_LOD_LEVELS> edge_caches;
+    std::array<MappedEdges, NUM_LOD_LEVELS> mapped_edges;
+    std::shared_ptr<const utils::MappedFile> mapped_storage;
+    mutable std::vector<GlyphSDF> sdf_cache;
+    mutable std::vector<bool> sdf_cache_valid;
 
 };
 
@@ -0,0 +1,40 @@
+#ifndef GLYPH_SDF_H
+#define GLYPH_SDF_H
+
+#include <span>
+#include <vector>
+#include <gfx/math/vec2.h>
+#include <gfx/math/box2.h>
+#include <gfx/text/contour-edge.h>
+
+namespace gfx::text
+{
+
+struct GlyphSDF
+{
+    gfx::math::Vec2i resolution { 0, 0 };
+    gfx::math::Vec2d origin { 0.0, 0.0 };
+    double texel_size = 1.0;
+    double spread = 1.0;
+
+    // Signed distances normalized by spread, positive inside the outline.
+    std::vector<float> distances;
+
+    inline bool empty() const { return distances.empty(); }
+
+    inline gfx::math::Box2d get_bounds() const
+    {
+        return gfx::math::Box2d {
+            origin,
+            origin + gfx::math::Vec2d { (resolution.x - 1) * texel_size, (resolution.y - 1) * texel_size }
+        };
+    }
+
+    double sample(const gfx::math::Vec2d point) const;
+};
+
+GlyphSDF generate_glyph_sdf(std::span<const ContourEdge> edges, const double texel_size, const double spread);
+
+}
+
+#endif // GLYPH_SDF_H
@@ -0,0 +1,65 @@
+#ifndef KERNING_TABLE_H
+#define KERNING_TABLE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gfx::text
+{
+
+struct KerningPair
+{
+    uint32_t key;
+    int16_t value;
+};
+
+struct KerningClassTable
+{
+    static constexpr uint16_t NOT_COVERED { 0xFFFF };
+
+    std::vector<uint16_t> left_classes;
+    std::vector<uint16_t> right_classes;
+    uint16_t num_right_classes = 0;
+    std::vector<int16_t> values;
+};
+
+class KerningTable
+{
+
+public:
+
+    KerningTable() = default;
+
+    // Takes pairs that are already sorted and deduplicated, as produced by finalize().
+    KerningTable(std::vector<KerningPair> &&pairs, std::vector<KerningClassTable> &&class_tables)
+        : pairs(std::move(pairs)), class_tables(std::move(class_tables)) {}
+
+    static inline uint32_t make_key(const uint16_t left, const uint16_t right)
+    {
+        return (static_cast<uint32_t>(left) << 16) | right;
+    }
+
+    int get(const uint16_t left, const uint16_t right) const;
+
+    void add_pair(const uint16_t left, const uint16_t right, const int16_t value);
+    void add_class_table(KerningClassTable &&table);
+
+    void finalize();
+
+    inline bool empty() const { return pairs.empty() && class_tables.empty(); }
+    inline std::size_t num_pairs() const { return pairs.size(); }
+    inline std::size_t num_class_tables() const { return class_tables.size(); }
+
+    inline const std::vector<KerningPair> &get_pairs() const { return pairs; }
+    inline const std::vector<KerningClassTable> &get_class_tables() const { return class_tables; }
+
+private:
+
+    std::vector<KerningPair> pairs;
+    std::vector<KerningClassTable> class_tables;
+};
+
+}
+
+#endif // KERNING_TABLE_H
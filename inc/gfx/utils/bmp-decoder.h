@@ -0,0 +1,22 @@
+#ifndef GFX_UTILS_BMP_DECODER_H
+#define GFX_UTILS_BMP_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <gfx/core/types/bitmap.h>
+
+namespace gfx::utils
+{
+
+// Decodes an uncompressed 24 or 32 bit BMP into an existing bitmap. The pixel storage is
+// reused when the resolution is unchanged, so decoding a sequence of equally sized frames
+// does not allocate.
+void decode_bmp(const std::filesystem::path &path, gfx::core::types::Bitmap &bitmap);
+void decode_bmp(const uint8_t* data, const std::size_t size, gfx::core::types::Bitmap &bitmap);
+
+gfx::core::types::Bitmap decode_bmp(const std::filesystem::path &path);
+
+}
+
+#endif // GFX_UTILS_BMP_DECODER_H
@@ -0,0 +1,90 @@
+#ifndef GFX_UTILS_IMAGE_SEQUENCE_H
+#define GFX_UTILS_IMAGE_SEQUENCE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gfx/core/types/bitmap.h>
+
+namespace gfx::utils
+{
+
+// Decodes a numbered sequence of BMP frames ahead of playback on a background thread. Frames
+// are kept in a fixed ring of bitmaps whose storage is reused, so steady playback does not
+// allocate.
+class ImageSequence
+{
+
+public:
+
+    using PathFunction = std::function<std::filesystem::path(const int index)>;
+    using ProcessFunction = std::function<void(gfx::core::types::Bitmap &frame)>;
+
+    // The process function runs on the decode thread after each frame is decoded.
+    ImageSequence(const PathFunction frame_path, const int num_frames, const std::size_t capacity = 8, const ProcessFunction process = {});
+    ~ImageSequence();
+
+    ImageSequence(const ImageSequence &) = delete;
+    ImageSequence &operator=(const ImageSequence &) = delete;
+
+    // Swaps the newest decoded frame not after `index` into `frame` and hands the old storage
+    // back to the ring. The frame keeps the version decoding gave it, along with any mip levels
+    // the process callback built from it. Older buffered frames, and frames playback
+    // has overtaken before they were decoded, are dropped. Returns false when there is no new
+    // frame to show. Going backwards seeks. Decode errors are rethrown here.
+    bool acquire(const int index, gfx::core::types::Bitmap &frame);
+
+    // Discards everything buffered and restarts decoding at `index`.
+    void seek(const int index);
+
+    // Index of the frame last handed out by acquire, or the target of the last seek.
+    int get_position() const;
+
+    inline int get_num_frames() const { return num_frames; }
+    inline std::size_t get_capacity() const { return slots.size(); }
+    std::size_t get_num_buffered() const;
+    std::size_t get_num_dropped() const;
+
+private:
+
+    struct Slot
+    {
+        gfx::core::types::Bitmap bitmap { gfx::math::Vec2i { 1, 1 } };
+        int index = -1;
+    };
+
+    void decode_loop();
+    void seek_locked(const int index);
+    void release_slot(const std::size_t slot);
+
+    PathFunction frame_path;
+    ProcessFunction process;
+    int num_frames = 0;
+
+    std::vector<Slot> slots;
+    std::deque<std::size_t> ready_slots;
+    std::vector<std::size_t> free_slots;
+
+    // Frames before the position can no longer be produced without seeking.
+    int position = 0;
+    int next_index = 0;
+    uint64_t generation = 0;
+    std::size_t num_dropped = 0;
+    std::exception_ptr error;
+
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+    std::thread worker;
+};
+
+}
+
+#endif // GFX_UTILS_IMAGE_SEQUENCE_H
@@ -0,0 +1,39 @@
+#ifndef GFX_UTILS_MAPPED_FILE_H
+#define GFX_UTILS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace gfx::utils
+{
+
+class MappedFile
+{
+
+public:
+
+    MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    inline const uint8_t* data() const { return mapped; }
+    inline std::size_t size() const { return length; }
+    inline bool empty() const { return length == 0; }
+
+private:
+
+    void release();
+
+    const uint8_t* mapped = nullptr;
+    std::size_t length = 0;
+};
+
+}
+
+#endif // GFX_UTILS_MAPPED_FILE_H
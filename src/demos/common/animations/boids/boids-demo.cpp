@@ -26,6 +26,19 @@ void BoidsDemo::init()
 
     mouse_influence_radius = perception_radius * 2.0;
 
+    std::vector<Vec2d> boid_shape {
+        { 0, -5 },
+        { 10, 0 },
+        { 0, 5 },
+        { 2, 0 },
+    };
+    auto boid_primitive { renderer->create_polyline(Vec2d::zero(), boid_shape, Color4(1.0, 1.0, 1.0, 1.0), 1.0) };
+    boid_primitive->set_anchor({ 0.2, 0.5 });
+    boid_primitive->set_fill(true);
+
+    boid_instances = renderer->create_instances(boid_primitive);
+    renderer->add_item(boid_instances);
+
     for (int i = 0; i < num_boids; ++i)
     {
         spawn_boid();
@@ -40,21 +53,9 @@ void BoidsDemo::init()
 
 void BoidsDemo::spawn_boid(const Vec2d position, const Vec2d velocity)
 {
-    std::vector<Vec2d> boid_shape {
-        { 0, -5 },
-        { 10, 0 },
-        { 0, 5 },
-        { 2, 0 },
-    };
-    auto boid_primitive { renderer->create_polyline(position, boid_shape, Color4(1.0, 1.0, 1.0, 1.0), 1.0) };
     std::shared_ptr<Boid> boid { std::make_shared<Boid>() };
     boid->velocity = velocity;
     boid->position = position;
-    boid->shape = boid_primitive;
-    boid->shape->set_anchor({ 0.2, 0.5 });
-    boid->shape->set_fill(true);
-    boid->shape->set_scale(renderer->get_resolution().x * 0.001 * boid_scale);
-    renderer->add_item(boid_primitive);
     boids.push_back(boid);
 }
 
@@ -74,7 +75,6 @@ void BoidsDemo::spawn_boid()
 
 void BoidsDemo::remove_boid(const std::shared_ptr<Boid> boid)
 {
-    renderer->remove_item(boid->shape);
     boids.erase(std::remove(boids.begin(), boids.end(), boid), boids.end());
 }
 
@@ -249,13 +249,20 @@ void BoidsDemo::process_boids(const double dt)
 
 void BoidsDemo::render_boids()
 {
-    for (auto &boid : boids)
+    double scale { renderer->get_resolution().x * 0.001 * boid_scale };
+
+    boid_instances->resize_instances(boids.size());
+    std::span<Instance2D> instances { boid_instances->edit_instances() };
+
+    for (size_t i = 0; i < boids.size(); ++i)
     {
-        boid->shape->set_position(boid->position);
-        double angle { std::atan2(boid->velocity.y, boid->velocity.x) };
-        boid->shape->set_rotation(angle);
+        const auto &boid { boids[i] };
         int color_index { static_cast<int>(boid->velocity.length()) };
-        boid->shape->set_color(boid_palette[std::clamp(color_index, 0, static_cast<int>(boid_palette.size()) - 1)]);
+
+        instances[i].position = boid->position;
+        instances[i].rotation = std::atan2(boid->velocity.y, boid->velocity.x);
+        instances[i].scale = Vec2d { scale, scale };
+        instances[i].color = boid_palette[std::clamp(color_index, 0, static_cast<int>(boid_palette.size()) - 1)];
     }
 }
 
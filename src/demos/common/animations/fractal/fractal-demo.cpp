@@ -95,7 +95,9 @@ void FractalDemo::render_frame(const double dt)
     // fractal.set_max_iterations(std::max(100 * std::log2(4.0 / (view.size().x)), 100.0));
     fractal.set_max_iterations(300);
 
-    Vec2i resolution { bitmap->get_resolution() };
+    // Rows are written straight into the bitmap the primitive draws from.
+    Bitmap &canvas { *bitmap->get_bitmap() };
+    Vec2i resolution { canvas.resolution };
     double aspect_ratio { static_cast<double>(resolution.x) / static_cast<double>(resolution.y) };
 
     unsigned int num_threads = { std::thread::hardware_concurrency() };
@@ -144,13 +146,13 @@ void FractalDemo::render_frame(const double dt)
                     int color_value = static_cast<int>(255.0 * smooth_iter / static_cast<double>(fractal.get_max_iterations()));
                     if (iterations >= fractal.get_max_iterations())
                     {
-                        bitmap->set_pixel({ x, y }, { 0, 0, 0, 0 });
+                        canvas.at(x, y) = { 0, 0, 0, 0 };
                         continue;
                     }
                     double t { static_cast<double>(iterations) / fractal.get_max_iterations() };
                     int color_index { static_cast<int>(t * num_colors) };
 
-                    bitmap->set_pixel({ x, y }, colors[color_index % colors.size()]);
+                    canvas.at(x, y) = colors[color_index % colors.size()];
                 }
             }
         };
@@ -167,6 +169,7 @@ void FractalDemo::render_frame(const double dt)
     {
         thread.join();
     }
+    canvas.touch();
 
     renderer->draw_frame();
 }
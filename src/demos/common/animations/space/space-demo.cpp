@@ -162,9 +162,11 @@ void SpaceDemo::update_trails(const double time_lerp)
     {
         for (const auto& [body, render] : body_items)
         {
-            body_trails[body] = std::vector<Vec2d>(trail_length, body->get_position());
+            body_trails[body] = std::deque<Vec2d>(trail_length, body->get_position());
+            render.trail->set_points(std::vector<Vec2d>(trail_length + 1, body->get_position()));
             render.trail->set_visible(false);
         }
+        trail_culling_dirty = true;
         return;
     }
     else
@@ -174,74 +176,70 @@ void SpaceDemo::update_trails(const double time_lerp)
             render.trail->set_visible(true);
         }
     }
+
+    // Trails are kept in world space and mapped to the screen through the primitive transform,
+    // so each frame only the moving head and tail points are restroked.
+    Vec2d pixels_per_metre { units::metres_to_pixels(Vec2d { 1.0, 1.0 }, view_bounds.size(), get_resolution()) };
+
+    // Segments well outside the view are hidden so the stroke pass skips them. Between view
+    // changes only the head and tail segments move, so only those are retested.
+    Vec2d cull_margin { view_bounds.size() * 0.1 };
+    Box2d cull_bounds { view_bounds.min - cull_margin, view_bounds.max + cull_margin };
+    bool cull_all { trail_culling_dirty || cull_bounds.min != trail_cull_bounds.min || cull_bounds.max != trail_cull_bounds.max };
+    trail_cull_bounds = cull_bounds;
+    trail_culling_dirty = false;
+
+    auto cull_segment { [&](Polyline2D &trail, const size_t segment) {
+        Box2d segment_bounds { trail.get_point(segment), trail.get_point(segment) };
+        segment_bounds.expand(trail.get_point(segment + 1));
+        bool visible { cull_bounds.intersects(segment_bounds) };
+        if (trail.get_segment_visible(segment) != visible)
+        {
+            trail.set_segment_visible(segment, visible);
+        }
+    } };
+
     for (const auto& [body, render] : body_items)
     {
         auto trail { render.trail };
-        std::vector<Vec2d>& trail_points_world { body_trails[body] };
+        std::deque<Vec2d>& trail_points_world { body_trails[body] };
 
         Vec2d trail_pos_world { Vec2d::lerp(render.previous_pos, body->get_position(), time_lerp) };
 
         double trail_point_spacing { view_bounds.size().length() * 0.01 };
-        double dist_to_last_point { Vec2d::distance(trail_points_world.back(), trail_pos_world) };
-        if (dist_to_last_point > trail_point_spacing)
+        if (Vec2d::distance(trail_points_world.back(), trail_pos_world) > trail_point_spacing)
         {
-            trail_points_world.erase(trail_points_world.begin());
+            trail_points_world.pop_front();
             trail_points_world.push_back(trail_pos_world);
+
+            trail->set_point(trail->get_num_points() - 1, trail_pos_world);
+            trail->push_point(trail_pos_world);
         }
+        double dist_to_last_point { Vec2d::distance(trail_points_world.back(), trail_pos_world) };
 
-        trail->clear_points();
-
-        trail->add_point(
-            units::metres_to_pixels(
-                Vec2d::lerp(
-                    trail_points_world[0] - view_bounds.min, 
-                    trail_points_world[1] - view_bounds.min,
-                    dist_to_last_point / trail_point_spacing
-                ),
-                view_bounds.size(), 
-                get_resolution()
-            )
-        );
+        trail->set_point(0, Vec2d::lerp(trail_points_world[0], trail_points_world[1], dist_to_last_point / trail_point_spacing));
+        trail->set_point(trail->get_num_points() - 1, trail_pos_world);
 
-        for (int i = 1; i < trail_points_world.size(); ++i)
+        size_t num_segments { trail->get_num_points() - 1 };
+        if (cull_all)
         {
-            Vec2d trail_point_screen { 
-                units::metres_to_pixels(
-                    trail_points_world[i] - view_bounds.min, 
-                    view_bounds.size(), 
-                    get_resolution()
-                ) 
-            };
-            double margin { renderer->get_resolution().length() * 1.0 };
-            if (trail_point_screen.x < -margin || trail_point_screen.x > get_resolution().x + margin ||
-                trail_point_screen.y < -margin || trail_point_screen.y > get_resolution().y + margin)
+            for (size_t segment = 0; segment < num_segments; ++segment)
             {
-                continue;
+                cull_segment(*trail, segment);
             }
-            trail->add_point(trail_point_screen);
-            trail->set_segment_visible(i, true);
         }
-        for (int i = 0; i < trail->get_num_points(); ++i)
+        else
         {
-            Vec2d point { trail->get_point(i) };
-            double margin { renderer->get_resolution().length() * 0.1 };
-            if (point.x < -margin || point.x > get_resolution().x + margin ||
-                point.y < -margin || point.y > get_resolution().y + margin)
+            // A pushed point also moves the end of the segment before the head.
+            for (size_t segment : { size_t { 0 }, num_segments - 2, num_segments - 1 })
             {
-                trail->set_segment_visible(i, false);
-                if (i > 0)
-                {
-                    trail->set_segment_visible(i - 1, false);
-                }
+                cull_segment(*trail, segment);
             }
         }
-        trail->add_point(
-            units::metres_to_pixels(
-                Vec2d::lerp(render.previous_pos, body->get_position(), time_lerp) - view_bounds.min, 
-                view_bounds.size(), 
-                get_resolution()
-            )
-        );
+
+        trail->set_scale(pixels_per_metre);
+        trail->set_position(-view_bounds.min * pixels_per_metre);
+        trail->set_line_thickness(1.0 / pixels_per_metre.x);
     }
 }
 
@@ -342,14 +340,16 @@ std::shared_ptr<Body> SpaceDemo::spawn_body(const std::string name, const Vec2d
     shape->set_anchor({ 0.5, 0.5 });
     renderer->add_item(shape);
 
-    auto trail = renderer->create_polyline({ 0, 0 }, std::vector<Vec2d>(trail_length, { 0, 0 }), Color4(1.0, 1.0, 1.0), 1.0);
+    auto trail = renderer->create_polyline({ 0, 0 }, std::vector<Vec2d>(trail_length + 1, position), Color4(1.0, 1.0, 1.0), 1.0);
+    trail->set_max_points(trail_length + 1);
     renderer->add_item(trail);
 
     RenderBody render_body { shape, trail };
 
     auto body = std::make_shared<Body>(name, position, velocity, radius, mass, locked, color);
 
-    body_trails[body] = std::vector<Vec2d>(trail_length, position);
+    body_trails[body] = std::deque<Vec2d>(trail_length, position);
+    trail_culling_dirty = true;
 
     body_items.emplace(std::make_pair(body, render_body));
     body_list.push_back(body);
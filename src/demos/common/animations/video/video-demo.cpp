@@ -14,6 +14,7 @@ using namespace demos::common::core;
 void VideoDemo::init()
 {
     load_video(videos[current_video]);
+    bitmap->set_mipmap_mode(MipmapMode::NEAREST);
 
     renderer->clear_items();
     Vec2i resolution { renderer->get_resolution() };
@@ -30,7 +31,6 @@ void VideoDemo::render_frame(const double dt)
     double time_ms { t0 / 1000.0 };
 
     double fps = 60.0;
-    int num_frames = 6573;
     renderer->clear_items();
 
     if (!paused)
@@ -43,17 +43,16 @@ void VideoDemo::render_frame(const double dt)
         time_since_last_frame = 0.0;
     }
 
-    if (frame_number >= num_frames)
+    if (frame_number >= NUM_FRAMES)
     {
         frame_number = 1;
     }
 
     Vec2i resolution { renderer->get_resolution() };
-    Bitmap bm { Bitmap::decode_bmp("/Users/sigurdsevaldrud/documents/code/c++/gfx/assets/" + video_name + "/" + std::to_string(frame_number) + ".bmp") };
-
-    bm.compress_colors(palette);
-    bitmap->load_bitmap(bm);
-    bitmap->set_scale(static_cast<double>(resolution.x) / static_cast<double>(bm.resolution.x));
+    if (sequence->acquire(frame_number - 1, *frame))
+    {
+        bitmap->set_scale(static_cast<double>(resolution.x) / static_cast<double>(frame->resolution.x));
+    }
     renderer->add_item(bitmap);
 
     renderer->draw_frame();
@@ -84,6 +83,21 @@ void VideoDemo::load_video(const Video video)
             load_bad_apple();
             break;
     }
+
+    std::string directory { "/Users/sigurdsevaldrud/documents/code/c++/gfx/assets/" + video_name + "/" };
+    Palette frame_palette { palette };
+
+    // Frames are numbered from 1 and playback wraps before NUM_FRAMES.
+    sequence = std::make_unique<gfx::utils::ImageSequence>(
+        [directory](const int index) { return directory + std::to_string(index + 1) + ".bmp"; },
+        NUM_FRAMES - 1,
+        FRAMES_AHEAD,
+        [frame_palette](Bitmap &frame) {
+            // Levels are built before quantizing so that every level stays within the palette.
+            frame.build_mipmaps();
+            frame.compress_colors(frame_palette);
+        }
+    );
 }
 
 void VideoDemo::load_bad_apple()
@@ -26,10 +26,13 @@ void run()
 
     while (running)
     {
-        clear();
         demo.render_frame(0);
         set_color(default_color::WHITE);
         std::vector<std::string> info { demo.info_text() };
+
+        // The surface only rewrites cells it changed, so have it repaint under the text.
+        surface->invalidate_text({ 0, 0 }, info);
+
         for (int i = 0; i < info.size(); ++i)
         {
             add_str({ 0, i }, info[i]);
@@ -142,6 +142,16 @@ std::shared_ptr<Bitmap2D> Render2D::create_bitmap(const Vec2d position, const gf
     return bitmap;
 }
 
+std::shared_ptr<Bitmap2D> Render2D::create_bitmap(const Vec2d position, const std::shared_ptr<gfx::core::types::Bitmap> &bm) const
+{
+    auto bitmap { std::make_shared<Bitmap2D>() };
+
+    bitmap->set_position(position);
+    bitmap->share_bitmap(bm);
+
+    return bitmap;
+}
+
 std::shared_ptr<Bitmap2D> Render2D::create_bitmap(const Vec2d position, const Vec2i resolution) const
 {
     auto bitmap { std::make_shared<Bitmap2D>() };
@@ -165,6 +175,16 @@ std::shared_ptr<Text2D> Render2D::create_text(const Vec2d position, const std::s
     return text_primitive;
 }
 
+std::shared_ptr<Instances2D> Render2D::create_instances(const std::shared_ptr<Primitive2D> prototype, const std::vector<Instance2D> &instances) const
+{
+    auto instances_primitive { std::make_shared<Instances2D>() };
+
+    instances_primitive->set_template(prototype);
+    instances_primitive->set_instances(std::vector<Instance2D>(instances));
+
+    return instances_primitive;
+}
+
 bool Render2D::collides(const Vec2d point, const std::shared_ptr<Primitive2D> primitive) const
 {
     Matrix3x3d global_transform { get_global_transform() * primitive->get_transform() };
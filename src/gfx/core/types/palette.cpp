@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <gfx/core/types/palette.h>
+#include <gfx/core/types/bitmap.h>
+
+namespace gfx::core::types
+{
+
+static constexpr int MIN_MULTITHREAD_PIXELS { 200 * 200 };
+
+static constexpr int BAYER_8X8[8][8] {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 }
+};
+
+static int squared_distance(const Color4 &a, const int r, const int g, const int b, const int alpha)
+{
+    int dr { a.r - r };
+    int dg { a.g - g };
+    int db { a.b - b };
+    int da { a.a - alpha };
+    return dr * dr + dg * dg + db * db + da * da;
+}
+
+static uint8_t clamp_channel(const double value)
+{
+    return static_cast<uint8_t>(std::clamp(value + 0.5, 0.0, 255.0));
+}
+
+Palette::Palette(const std::vector<Color4> &colors)
+    : colors(colors)
+{
+    if (colors.size() > std::numeric_limits<uint16_t>::max())
+    {
+        throw std::runtime_error("Palette has too many colors: " + std::to_string(colors.size()));
+    }
+
+    if (colors.empty())
+    {
+        return;
+    }
+
+    constexpr int CELL_WIDTH { 256 / CUBE_SIZE };
+    std::vector<int> min_distances(colors.size());
+    cell_offsets.reserve(CUBE_SIZE * CUBE_SIZE * CUBE_SIZE + 1);
+    cell_offsets.push_back(0);
+
+    // Per channel, the closest and furthest a cell's range gets to a palette value.
+    auto channel_range = [](const int value, const int low, const int high, int &near, int &far) {
+        near = value < low ? low - value : (value > high ? value - high : 0);
+        far = std::max(std::abs(value - low), std::abs(value - high));
+    };
+
+    for (int cell_r = 0; cell_r < CUBE_SIZE; ++cell_r)
+    {
+        for (int cell_g = 0; cell_g < CUBE_SIZE; ++cell_g)
+        {
+            for (int cell_b = 0; cell_b < CUBE_SIZE; ++cell_b)
+            {
+                int low[3] { cell_r * CELL_WIDTH, cell_g * CELL_WIDTH, cell_b * CELL_WIDTH };
+                int bound { std::numeric_limits<int>::max() };
+
+                for (std::size_t i = 0; i < colors.size(); ++i)
+                {
+                    const Color4 &color { colors[i] };
+                    int value[3] { color.r, color.g, color.b };
+                    int alpha { 255 - color.a };
+                    int near_distance { alpha * alpha };
+                    int far_distance { alpha * alpha };
+
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        int near, far;
+                        channel_range(value[c], low[c], low[c] + CELL_WIDTH - 1, near, far);
+                        near_distance += near * near;
+                        far_distance += far * far;
+                    }
+
+                    min_distances[i] = near_distance;
+                    bound = std::min(bound, far_distance);
+                }
+
+                // Any entry that is nearest somewhere in the cell is at most `bound` away.
+                for (std::size_t i = 0; i < colors.size(); ++i)
+                {
+                    if (min_distances[i] <= bound)
+                    {
+                        cell_candidates.push_back(static_cast<uint16_t>(i));
+                    }
+                }
+                cell_offsets.push_back(static_cast<uint32_t>(cell_candidates.size()));
+            }
+        }
+    }
+
+    // Ordered dithering spreads each channel by the typical gap between neighbouring entries.
+    if (colors.size() > 1)
+    {
+        double total { 0.0 };
+        for (std::size_t i = 0; i < colors.size(); ++i)
+        {
+            int closest { std::numeric_limits<int>::max() };
+            for (std::size_t j = 0; j < colors.size(); ++j)
+            {
+                if (i != j)
+                {
+                    closest = std::min(closest, squared_distance(colors[j], colors[i].r, colors[i].g, colors[i].b, colors[j].a));
+                }
+            }
+            total += std::sqrt(static_cast<double>(closest) / 3.0);
+        }
+        ordered_spread = total / colors.size();
+    }
+}
+
+std::size_t Palette::nearest_index(const Color4 color) const
+{
+    if (color.a == 255)
+    {
+        return nearest_opaque(color.r, color.g, color.b);
+    }
+    return nearest_exhaustive(color);
+}
+
+std::size_t Palette::nearest_exhaustive(const Color4 color) const
+{
+    std::size_t best { 0 };
+    int best_distance { std::numeric_limits<int>::max() };
+    for (std::size_t i = 0; i < colors.size(); ++i)
+    {
+        int distance { squared_distance(colors[i], color.r, color.g, color.b, color.a) };
+        if (distance < best_distance)
+        {
+            best_distance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+std::size_t Palette::nearest_opaque(const int r, const int g, const int b) const
+{
+    int shift { 8 - CUBE_BITS };
+    int cell { ((r >> shift) << (2 * CUBE_BITS)) | ((g >> shift) << CUBE_BITS) | (b >> shift) };
+    uint32_t begin { cell_offsets[cell] };
+    uint32_t end { cell_offsets[cell + 1] };
+
+    if (end - begin == 1)
+    {
+        return cell_candidates[begin];
+    }
+
+    std::size_t best { cell_candidates[begin] };
+    int best_distance { std::numeric_limits<int>::max() };
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        int distance { squared_distance(colors[cell_candidates[i]], r, g, b, 255) };
+        if (distance < best_distance)
+        {
+            best_distance = distance;
+            best = cell_candidates[i];
+        }
+    }
+    return best;
+}
+
+void Palette::quantize(Bitmap &bitmap, const Dither dither) const
+{
+    if (colors.empty())
+    {
+        return;
+    }
+
+    if (dither == Dither::FLOYD_STEINBERG)
+    {
+        quantize_error_diffusion(bitmap);
+        return;
+    }
+
+    int height { bitmap.resolution.y };
+    if (bitmap.resolution.x * height < MIN_MULTITHREAD_PIXELS)
+    {
+        quantize_rows(bitmap, dither, 0, height);
+        return;
+    }
+
+    unsigned int num_threads { std::max(1u, std::thread::hardware_concurrency()) };
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < num_threads; ++i)
+    {
+        int start_y { static_cast<int>(i * height / num_threads) };
+        int end_y { static_cast<int>((i + 1) * height / num_threads) };
+        threads.emplace_back([this, &bitmap, dither, start_y, end_y]() {
+            quantize_rows(bitmap, dither, start_y, end_y);
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void Palette::quantize_rows(Bitmap &bitmap, const Dither dither, const int start_y, const int end_y) const
+{
+    for (int y = start_y; y < end_y; ++y)
+    {
+        for (int x = 0; x < bitmap.resolution.x; ++x)
+        {
+            Color4 &pixel { bitmap.at(x, y) };
+
+            if (dither == Dither::ORDERED && pixel.a == 255)
+            {
+                double offset { ((BAYER_8X8[y & 7][x & 7] + 0.5) / 64.0 - 0.5) * ordered_spread };
+                pixel = colors[nearest_opaque(clamp_channel(pixel.r + offset), clamp_channel(pixel.g + offset), clamp_channel(pixel.b + offset))];
+                continue;
+            }
+
+            pixel = colors[nearest_index(pixel)];
+        }
+    }
+}
+
+void Palette::quantize_error_diffusion(Bitmap &bitmap) const
+{
+    int width { bitmap.resolution.x };
+
+    // Error carried into the current and the next row, three channels per pixel, with a
+    // pixel of padding on either side.
+    std::vector<float> current((width + 2) * 3, 0.0f);
+    std::vector<float> next((width + 2) * 3, 0.0f);
+
+    for (int y = 0; y < bitmap.resolution.y; ++y)
+    {
+        std::fill(next.begin(), next.end(), 0.0f);
+
+        for (int x = 0; x < width; ++x)
+        {
+            Color4 &pixel { bitmap.at(x, y) };
+            if (pixel.a != 255)
+            {
+                pixel = colors[nearest_exhaustive(pixel)];
+                continue;
+            }
+
+            float* error { &current[(x + 1) * 3] };
+            float wanted[3] { pixel.r + error[0], pixel.g + error[1], pixel.b + error[2] };
+
+            const Color4 &chosen { colors[nearest_opaque(clamp_channel(wanted[0]), clamp_channel(wanted[1]), clamp_channel(wanted[2]))] };
+            float residual[3] { wanted[0] - chosen.r, wanted[1] - chosen.g, wanted[2] - chosen.b };
+            pixel = chosen;
+
+            for (int c = 0; c < 3; ++c)
+            {
+                current[(x + 2) * 3 + c] += residual[c] * (7.0f / 16.0f);
+                next[x * 3 + c] += residual[c] * (3.0f / 16.0f);
+                next[(x + 1) * 3 + c] += residual[c] * (5.0f / 16.0f);
+                next[(x + 2) * 3 + c] += residual[c] * (1.0f / 16.0f);
+            }
+        }
+
+        std::swap(current, next);
+    }
+}
+
+}
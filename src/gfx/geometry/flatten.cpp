@@ -1,4 +1,5 @@
-#include <stack>
+#include <algorithm>
+#include <cmath>
 #include <gfx/geometry/flatten.h>
 
 namespace gfx::geometry
@@ -6,80 +7,67 @@ namespace gfx::geometry
 
 using namespace gfx::math;
 
-std::vector<Vec2d> flatten_bezier(const Vec2d p0, const Vec2d p1, const Vec2d p2, const double tolerance)
+int quadratic_segment_count(const Vec2d p0, const Vec2d p1, const Vec2d p2, const double tolerance)
 {
-    struct BezierSegment
+    // The second derivative of a quadratic is constant (2 * (p0 - 2 p1 + p2)), so the
+    // chord error of a uniform step h is bounded by |p0 - 2 p1 + p2| * h^2 / 4.
+    double curvature { (p0 - p1 * 2.0 + p2).length() };
+    if (curvature <= 0.0)
     {
-        double t0;
-        double t1;
-        Vec2d p0;
-        Vec2d p1;
-    };
-
-    auto bezier_eval { [](const Vec2d &p0, const Vec2d &p1, const Vec2d &p2, const double t) {
-        double u = 1.0 - t;
-        return Vec2d {
-            u * u * p0.x + 2 * u * t * p1.x + t * t * p2.x,
-            u * u * p0.y + 2 * u * t * p1.y + t * t * p2.y
-        };
-    } };
-
-    std::vector<Vec2d> points;
-    std::stack<BezierSegment> segments;
-
-    Vec2d start { bezier_eval(p0, p1, p2, 0.0) };
-    Vec2d end { bezier_eval(p0, p1, p2, 1.0) };
+        return 1;
+    }
 
-    segments.push({ 0.0, 1.0, start, end });
+    double segments { std::ceil(std::sqrt(curvature / (4.0 * std::max(tolerance, 1e-9)))) };
+    return static_cast<int>(std::clamp(segments, 1.0, static_cast<double>(MAX_BEZIER_SEGMENTS)));
+}
 
-    while (!segments.empty())
-    {
-        BezierSegment segment { segments.top() };
-        segments.pop();
+void flatten_bezier(const Vec2d p0, const Vec2d p1, const Vec2d p2, const double tolerance, std::vector<Vec2d> &points)
+{
+    int num_segments { quadratic_segment_count(p0, p1, p2, tolerance) };
 
-        double mid_t { (segment.t0 + segment.t1) / 2.0 };
-        Vec2d mid_point { bezier_eval(p0, p1, p2, mid_t) };
+    double h { 1.0 / num_segments };
+    Vec2d a { p0 - p1 * 2.0 + p2 };
+    Vec2d b { (p1 - p0) * 2.0 };
 
-        Vec2d line_mid { (segment.p0 + segment.p1) / 2.0 };
-        double distance { (mid_point - line_mid).length() };
+    Vec2d point { p0 };
+    Vec2d delta { b * h + a * (h * h) };
+    Vec2d delta_step { a * (2.0 * h * h) };
 
-        if (distance > tolerance)
-        {
-            segments.push({ mid_t, segment.t1, mid_point, segment.p1 });
-            segments.push({ segment.t0, mid_t, segment.p0, mid_point });
-        }
-        else
-        {
-            if (points.empty() || points.back() != segment.p0)
-            {
-                points.push_back(segment.p0);
-            }
-            points.push_back(segment.p1);
-        }
+    for (int i = 1; i < num_segments; ++i)
+    {
+        point += delta;
+        delta += delta_step;
+        points.push_back(point);
     }
-
-    points.push_back(end);
-    return points;
+    points.push_back(p2);
 }
 
-std::vector<Vec2d> flatten_contour(const std::vector<std::pair<Vec2d, bool>> &points_on_off_curve)
+void flatten_contour(const std::vector<std::pair<Vec2d, bool>> &points_on_off_curve, const double tolerance, std::vector<Vec2d> &points)
 {
-    std::vector<Vec2d> flattened_points;
+    int num_points { static_cast<int>(points_on_off_curve.size()) };
+    if (num_points == 0)
+    {
+        return;
+    }
+
+    auto start { std::find_if(points_on_off_curve.begin(), points_on_off_curve.end(), [](const auto &point) {
+        return point.second;
+    }) };
 
     int start_index;
-    for (int i = 0; i < points_on_off_curve.size(); ++i)
+    Vec2d prev_on_point;
+    if (start != points_on_off_curve.end())
     {
-        if (points_on_off_curve[i].second)
-        {
-            start_index = i;
-            break;
-        }
+        start_index = static_cast<int>(start - points_on_off_curve.begin());
+        prev_on_point = start->first;
+    }
+    else
+    {
+        start_index = num_points - 1;
+        prev_on_point = (points_on_off_curve[num_points - 1].first + points_on_off_curve[0].first) / 2.0;
     }
 
-    Vec2d prev_on_point { points_on_off_curve[start_index].first.x, points_on_off_curve[start_index].first.y };
-    flattened_points.push_back(prev_on_point);
-
-    int num_points { static_cast<int>(points_on_off_curve.size()) };
+    points.push_back(prev_on_point);
 
     for (int i = 1; i <= num_points; ++i)
     {
@@ -87,31 +75,40 @@ std::vector<Vec2d> flatten_contour(const std::vector<std::pair<Vec2d, bool>> &po
 
         if (curr_point.second)
         {
-            Vec2d curr_on_point { curr_point.first.x, curr_point.first.y };
-            flattened_points.push_back(curr_on_point);
-            prev_on_point = curr_on_point;
+            points.push_back(curr_point.first);
+            prev_on_point = curr_point.first;
         }
         else
         {
             const auto &next_point { points_on_off_curve[(start_index + i + 1) % num_points] };
             if (next_point.second)
             {
-                Vec2d next_on_point { next_point.first.x, next_point.first.y };
-                auto bezier_points { flatten_bezier(prev_on_point, Vec2d { curr_point.first.x, curr_point.first.y }, next_on_point) };
-                flattened_points.insert(flattened_points.end(), bezier_points.begin() + 1, bezier_points.end());
-                prev_on_point = next_on_point;
+                flatten_bezier(prev_on_point, curr_point.first, next_point.first, tolerance, points);
+                prev_on_point = next_point.first;
                 ++i;
             }
             else
             {
-                Vec2d mid_point { (Vec2d { curr_point.first.x, curr_point.first.y } + Vec2d { next_point.first.x, next_point.first.y }) / 2.0 };
-                auto bezier_points { flatten_bezier(prev_on_point, Vec2d { curr_point.first.x, curr_point.first.y }, mid_point) };
-                flattened_points.insert(flattened_points.end(), bezier_points.begin() + 1, bezier_points.end());
+                Vec2d mid_point { (curr_point.first + next_point.first) / 2.0 };
+                flatten_bezier(prev_on_point, curr_point.first, mid_point, tolerance, points);
                 prev_on_point = mid_point;
             }
         }
     }
-    return flattened_points;
+}
+
+std::vector<Vec2d> flatten_bezier(const Vec2d p0, const Vec2d p1, const Vec2d p2, const double tolerance)
+{
+    std::vector<Vec2d> points { p0 };
+    flatten_bezier(p0, p1, p2, tolerance, points);
+    return points;
+}
+
+std::vector<Vec2d> flatten_contour(const std::vector<std::pair<Vec2d, bool>> &points_on_off_curve, const double tolerance)
+{
+    std::vector<Vec2d> points;
+    flatten_contour(points_on_off_curve, tolerance, points);
+    return points;
 }
 
 }
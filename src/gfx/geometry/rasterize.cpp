@@ -136,4 +136,107 @@ void rasterize_filled_triangle(const Triangle &triangle, const Color4 color, con
     }
 }
 
+void rasterize_ellipse(const Vec2d center, const Vec2d outer_radius, const Vec2d inner_radius, const Matrix3x3d &transform, const Color4 color, const std::function<void(const Pixel&)> emit_pixel)
+{
+    if (outer_radius.x <= 0.0 || outer_radius.y <= 0.0)
+    {
+        return;
+    }
+
+    Matrix3x3d inverse { utils::invert_affine(transform) };
+    bool hollow { inner_radius.x > 0.0 && inner_radius.y > 0.0 };
+
+    Vec2d transformed_center { utils::transform_point(center, transform) };
+    double half_height { std::hypot(transform(1, 0) * outer_radius.x, transform(1, 1) * outer_radius.y) };
+    int min_y { static_cast<int>(std::ceil(transformed_center.y - half_height)) };
+    int max_y { static_cast<int>(std::floor(transformed_center.y + half_height)) };
+
+    // Along row y the local point is origin + x * step, so inside the unit-scaled conic
+    // |origin + x * step|^2 <= 1 is a quadratic in x.
+    auto solve_row = [&](const Vec2d radius, const int y, double &x0, double &x1) {
+        Vec2d origin {
+            (inverse(0, 1) * y + inverse(0, 2) - center.x) / radius.x,
+            (inverse(1, 1) * y + inverse(1, 2) - center.y) / radius.y
+        };
+        Vec2d step { inverse(0, 0) / radius.x, inverse(1, 0) / radius.y };
+
+        double a { step.x * step.x + step.y * step.y };
+        double b { origin.x * step.x + origin.y * step.y };
+        double c { origin.x * origin.x + origin.y * origin.y - 1.0 };
+
+        double discriminant { b * b - a * c };
+        if (a == 0.0 || discriminant < 0.0)
+        {
+            return false;
+        }
+
+        double root { std::sqrt(discriminant) };
+        x0 = (-b - root) / a;
+        x1 = (-b + root) / a;
+        return true;
+    };
+
+    auto emit_span = [&](const int y, const int x0, const int x1) {
+        for (int x = x0; x <= x1; ++x)
+        {
+            emit_pixel(Pixel { { x, y }, color });
+        }
+    };
+
+    auto worker = [&](const int start_y, const int end_y) {
+        for (int y = start_y; y <= end_y; ++y)
+        {
+            double outer0;
+            double outer1;
+            if (!solve_row(outer_radius, y, outer0, outer1))
+            {
+                continue;
+            }
+
+            int left { static_cast<int>(std::ceil(outer0)) };
+            int right { static_cast<int>(std::floor(outer1)) };
+
+            double inner0;
+            double inner1;
+            if (hollow && solve_row(inner_radius, y, inner0, inner1))
+            {
+                // Pixels on the inner boundary belong to the ring.
+                int hole_left { static_cast<int>(std::floor(inner0)) + 1 };
+                int hole_right { static_cast<int>(std::ceil(inner1)) - 1 };
+                if (hole_left <= hole_right)
+                {
+                    emit_span(y, left, std::min(right, hole_left - 1));
+                    emit_span(y, std::max(left, hole_right + 1), right);
+                    continue;
+                }
+            }
+
+            emit_span(y, left, right);
+        }
+    };
+
+    double half_width { std::hypot(transform(0, 0) * outer_radius.x, transform(0, 1) * outer_radius.y) };
+    if (4.0 * half_width * half_height < MIN_MULTITHREAD_PIXELS)
+    {
+        worker(min_y, max_y);
+        return;
+    }
+
+    unsigned int num_threads { std::max(1u, std::thread::hardware_concurrency()) };
+    int num_rows { max_y - min_y + 1 };
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < num_threads; ++i)
+    {
+        int start_y { min_y + static_cast<int>(i * num_rows / num_threads) };
+        int end_y { min_y + static_cast<int>((i + 1) * num_rows / num_threads) - 1 };
+        threads.emplace_back(worker, start_y, end_y);
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
 }
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cmath>
+#include <gfx/geometry/scanline.h>
+
+namespace gfx::geometry
+{
+
+using namespace gfx::core::types;
+using namespace gfx::geometry::types;
+using namespace gfx::math;
+
+
+void append_contour_edges(const std::vector<Vec2d> &contour, std::vector<Edge> &edges)
+{
+    if (contour.size() < 2)
+    {
+        return;
+    }
+
+    for (std::size_t i = 0; i < contour.size(); ++i)
+    {
+        edges.push_back({ contour[i], contour[(i + 1) % contour.size()] });
+    }
+}
+
+void rasterize_filled_spans(std::span<const Edge> edges, const FillRule fill_rule, const std::function<void(const int y, const int x0, const int x1)> emit_span)
+{
+    struct ScanEdge
+    {
+        int row_start;
+        int row_end;
+        double x;
+        double dxdy;
+        int winding;
+    };
+
+    // Rows sample at pixel centers; an edge covers the rows whose center lies in
+    // [top, bottom), so shared vertices and adjacent polygons are never filled twice.
+    std::vector<ScanEdge> scan_edges;
+    scan_edges.reserve(edges.size());
+
+    for (const auto &edge : edges)
+    {
+        if (edge.v0.y == edge.v1.y)
+        {
+            continue;
+        }
+
+        bool downward { edge.v1.y > edge.v0.y };
+        const Vec2d &top { downward ? edge.v0 : edge.v1 };
+        const Vec2d &bottom { downward ? edge.v1 : edge.v0 };
+
+        int row_start { static_cast<int>(std::ceil(top.y - 0.5)) };
+        int row_end { static_cast<int>(std::ceil(bottom.y - 0.5)) };
+        if (row_start >= row_end)
+        {
+            continue;
+        }
+
+        double dxdy { (bottom.x - top.x) / (bottom.y - top.y) };
+        double x { top.x + (row_start + 0.5 - top.y) * dxdy };
+
+        scan_edges.push_back({ row_start, row_end, x, dxdy, downward ? 1 : -1 });
+    }
+
+    if (scan_edges.empty())
+    {
+        return;
+    }
+
+    std::sort(scan_edges.begin(), scan_edges.end(), [](const ScanEdge &a, const ScanEdge &b) {
+        return a.row_start < b.row_start;
+    });
+
+    auto emit { [&](const int y, const double x_left, const double x_right) {
+        int x0 { static_cast<int>(std::ceil(x_left - 0.5)) };
+        int x1 { static_cast<int>(std::ceil(x_right - 0.5)) - 1 };
+        if (x0 <= x1)
+        {
+            emit_span(y, x0, x1);
+        }
+    } };
+
+    std::vector<ScanEdge> active;
+    std::size_t next_edge = 0;
+    int y { scan_edges[0].row_start };
+
+    while (next_edge < scan_edges.size() || !active.empty())
+    {
+        if (active.empty())
+        {
+            y = std::max(y, scan_edges[next_edge].row_start);
+        }
+
+        std::size_t num_active { active.size() };
+        while (next_edge < scan_edges.size() && scan_edges[next_edge].row_start <= y)
+        {
+            active.push_back(scan_edges[next_edge++]);
+        }
+
+        auto by_x { [](const ScanEdge &a, const ScanEdge &b) { return a.x < b.x; } };
+        if (active.size() != num_active)
+        {
+            std::sort(active.begin() + num_active, active.end(), by_x);
+            std::inplace_merge(active.begin(), active.begin() + num_active, active.end(), by_x);
+        }
+
+        // Crossings move little between rows, so the list stays nearly sorted.
+        for (std::size_t i = 1; i < active.size(); ++i)
+        {
+            ScanEdge edge { active[i] };
+            std::size_t j { i };
+            while (j > 0 && active[j - 1].x > edge.x)
+            {
+                active[j] = active[j - 1];
+                --j;
+            }
+            active[j] = edge;
+        }
+
+        if (fill_rule == FillRule::EVEN_ODD)
+        {
+            for (std::size_t i = 0; i + 1 < active.size(); i += 2)
+            {
+                emit(y, active[i].x, active[i + 1].x);
+            }
+        }
+        else
+        {
+            int winding = 0;
+            double span_start = 0.0;
+            for (const auto &edge : active)
+            {
+                int previous { winding };
+                winding += edge.winding;
+
+                if (previous == 0 && winding != 0)
+                {
+                    span_start = edge.x;
+                }
+                else if (previous != 0 && winding == 0)
+                {
+                    emit(y, span_start, edge.x);
+                }
+            }
+        }
+
+        ++y;
+
+        active.erase(std::remove_if(active.begin(), active.end(), [y](const ScanEdge &edge) {
+            return edge.row_end <= y;
+        }), active.end());
+
+        for (auto &edge : active)
+        {
+            edge.x += edge.dxdy;
+        }
+    }
+}
+
+void rasterize_filled_edges(std::span<const Edge> edges, const FillRule fill_rule, const Color4 color, const std::function<void(const Pixel&)> emit_pixel)
+{
+    rasterize_filled_spans(edges, fill_rule, [&](const int y, const int x0, const int x1) {
+        for (int x = x0; x <= x1; ++x)
+        {
+            emit_pixel({ { x, y }, color });
+        }
+    });
+}
+
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <gfx/geometry/simplify.h>
+
+namespace gfx::geometry
+{
+
+using namespace gfx::math;
+
+
+static double distance_to_segment_squared(const Vec2d point, const Vec2d a, const Vec2d b)
+{
+    Vec2d ab { b - a };
+    Vec2d ap { point - a };
+    double length_squared { ab.x * ab.x + ab.y * ab.y };
+
+    double t { length_squared > 0.0 ? std::clamp((ap.x * ab.x + ap.y * ab.y) / length_squared, 0.0, 1.0) : 0.0 };
+    Vec2d offset { ap - ab * t };
+    return offset.x * offset.x + offset.y * offset.y;
+}
+
+void simplify_polyline(std::span<const Vec2d> points, const double tolerance, std::vector<size_t> &kept)
+{
+    if (points.size() < 3)
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            kept.push_back(i);
+        }
+        return;
+    }
+
+    // Dense clusters are collapsed first in a single linear pass, which keeps the
+    // recursive pass near O(n log n) on sampled data. Each pass uses half the tolerance.
+    double half_tolerance_squared { tolerance * tolerance / 4.0 };
+
+    std::vector<size_t> candidates { 0 };
+    for (size_t i = 1; i + 1 < points.size(); ++i)
+    {
+        Vec2d delta { points[i] - points[candidates.back()] };
+        if (delta.x * delta.x + delta.y * delta.y > half_tolerance_squared)
+        {
+            candidates.push_back(i);
+        }
+    }
+    candidates.push_back(points.size() - 1);
+
+    std::vector<bool> keep(candidates.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+
+    std::vector<std::pair<size_t, size_t>> stack { { 0, candidates.size() - 1 } };
+    while (!stack.empty())
+    {
+        auto [first, last] { stack.back() };
+        stack.pop_back();
+
+        Vec2d a { points[candidates[first]] };
+        Vec2d b { points[candidates[last]] };
+
+        double max_distance { 0.0 };
+        size_t farthest { first };
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            double distance { distance_to_segment_squared(points[candidates[i]], a, b) };
+            if (distance > max_distance)
+            {
+                max_distance = distance;
+                farthest = i;
+            }
+        }
+
+        if (max_distance > half_tolerance_squared)
+        {
+            keep[farthest] = true;
+            stack.push_back({ first, farthest });
+            stack.push_back({ farthest, last });
+        }
+    }
+
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (keep[i])
+        {
+            kept.push_back(candidates[i]);
+        }
+    }
+}
+
+}
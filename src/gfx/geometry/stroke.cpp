@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <gfx/geometry/stroke.h>
+#include <gfx/geometry/scanline.h>
+
+namespace gfx::geometry
+{
+
+using namespace gfx::math;
+using namespace gfx::geometry::types;
+
+
+static double cross(const Vec2d a, const Vec2d b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+static double dot(const Vec2d a, const Vec2d b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+static void append_arc(const Vec2d center, const double radius, const Vec2d from, const double sweep, const double tolerance, std::vector<Vec2d> &points)
+{
+    // Largest step whose chord stays within tolerance of the arc.
+    double max_step { radius > tolerance ? 2.0 * std::acos(1.0 - tolerance / radius) : std::numbers::pi / 2.0 };
+    int steps { std::max(1, static_cast<int>(std::ceil(std::abs(sweep) / max_step))) };
+
+    double start { std::atan2(from.y, from.x) };
+    for (int i = 1; i < steps; ++i)
+    {
+        double angle { start + sweep * i / steps };
+        points.push_back(center + Vec2d { std::cos(angle), std::sin(angle) } * radius);
+    }
+}
+
+static void append_join(const Vec2d pivot, const Vec2d n0, const Vec2d n1, const double side, const StrokeStyle &style, std::vector<Vec2d> &points)
+{
+    double half_width { style.width / 2.0 };
+    Vec2d offset0 { n0 * (side * half_width) };
+    Vec2d offset1 { n1 * (side * half_width) };
+
+    double turn { cross(n0, n1) };
+    bool outer { turn * side < 0.0 };
+
+    points.push_back(pivot + offset0);
+
+    // Inner side: route through the pivot so the outline equals the sum of the
+    // segment quads and joins, which the non-zero rule fills exactly once.
+    if (!outer)
+    {
+        if (turn != 0.0)
+        {
+            points.push_back(pivot);
+        }
+        points.push_back(pivot + offset1);
+        return;
+    }
+
+    switch (style.join)
+    {
+        case LineJoin::MITER:
+        {
+            Vec2d bisector { (n0 + n1).normalize() };
+            double cos_half { dot(bisector, n0) };
+            if (cos_half > 0.0 && 1.0 / cos_half <= style.miter_limit)
+            {
+                points.push_back(pivot + bisector * (side * half_width / cos_half));
+            }
+            break;
+        }
+        case LineJoin::ROUND:
+        {
+            double sweep { std::atan2(cross(offset0, offset1), dot(offset0, offset1)) };
+            append_arc(pivot, half_width, offset0, sweep, style.tolerance, points);
+            break;
+        }
+        case LineJoin::BEVEL:
+            break;
+    }
+
+    points.push_back(pivot + offset1);
+}
+
+static void append_cap(const Vec2d end, const Vec2d direction, const Vec2d normal, const StrokeStyle &style, std::vector<Vec2d> &points)
+{
+    double half_width { style.width / 2.0 };
+
+    switch (style.cap)
+    {
+        case LineCap::BUTT:
+            break;
+        case LineCap::SQUARE:
+            points.push_back(end + (direction + normal) * half_width);
+            points.push_back(end + (direction - normal) * half_width);
+            break;
+        case LineCap::ROUND:
+            append_arc(end, half_width, normal, -std::numbers::pi, style.tolerance, points);
+            break;
+    }
+}
+
+void stroke_polyline(const std::vector<Vec2d> &points, const bool closed, const StrokeStyle &style, std::vector<Edge> &edges)
+{
+    std::vector<Vec2d> path;
+    path.reserve(points.size());
+    for (const auto &point : points)
+    {
+        if (path.empty() || point != path.back())
+        {
+            path.push_back(point);
+        }
+    }
+
+    bool loop { closed && path.size() > 2 };
+    if (loop && path.front() == path.back())
+    {
+        path.pop_back();
+    }
+
+    if (path.size() < 2 || style.width <= 0.0)
+    {
+        return;
+    }
+
+    int num_points { static_cast<int>(path.size()) };
+    int num_segments { loop ? num_points : num_points - 1 };
+
+    std::vector<Vec2d> normals(num_segments);
+    std::vector<Vec2d> directions(num_segments);
+    for (int i = 0; i < num_segments; ++i)
+    {
+        directions[i] = (path[(i + 1) % num_points] - path[i]).normalize();
+        normals[i] = Vec2d { -directions[i].y, directions[i].x };
+    }
+
+    double half_width { style.width / 2.0 };
+    std::vector<Vec2d> left;
+    std::vector<Vec2d> right;
+
+    if (!loop)
+    {
+        left.push_back(path[0] + normals[0] * half_width);
+        right.push_back(path[0] - normals[0] * half_width);
+    }
+
+    int first_join { loop ? 0 : 1 };
+    int last_join { loop ? num_points - 1 : num_points - 2 };
+    for (int i = first_join; i <= last_join; ++i)
+    {
+        int previous { (i - 1 + num_segments) % num_segments };
+        append_join(path[i], normals[previous], normals[i], 1.0, style, left);
+        append_join(path[i], normals[previous], normals[i], -1.0, style, right);
+    }
+
+    if (loop)
+    {
+        std::reverse(right.begin(), right.end());
+        append_contour_edges(left, edges);
+        append_contour_edges(right, edges);
+        return;
+    }
+
+    Vec2d end { path.back() };
+    left.push_back(end + normals.back() * half_width);
+    append_cap(end, directions.back(), normals.back(), style, left);
+    right.push_back(end - normals.back() * half_width);
+
+    std::vector<Vec2d> outline { std::move(left) };
+    outline.insert(outline.end(), right.rbegin(), right.rend());
+    append_cap(path[0], -directions[0], -normals[0], style, outline);
+
+    append_contour_edges(outline, edges);
+}
+
+void stroke_segment(const Vec2d p0, const Vec2d p1, const StrokeStyle &style, std::vector<Edge> &edges)
+{
+    if (p0 == p1 || style.width <= 0.0)
+    {
+        return;
+    }
+
+    Vec2d direction { (p1 - p0).normalize() };
+    Vec2d offset { Vec2d { -direction.y, direction.x } * (style.width / 2.0) };
+
+    append_contour_edges({ p0 + offset, p1 + offset, p1 - offset, p0 - offset }, edges);
+}
+
+void stroke_join(const Vec2d p0, const Vec2d pivot, const Vec2d p1, const StrokeStyle &style, std::vector<Edge> &edges)
+{
+    if (p0 == pivot || pivot == p1 || style.width <= 0.0)
+    {
+        return;
+    }
+
+    Vec2d direction0 { (pivot - p0).normalize() };
+    Vec2d direction1 { (p1 - pivot).normalize() };
+    Vec2d n0 { -direction0.y, direction0.x };
+    Vec2d n1 { -direction1.y, direction1.x };
+
+    double turn { cross(n0, n1) };
+    if (turn == 0.0)
+    {
+        return;
+    }
+
+    // The join only fills the wedge on the outer side of the turn.
+    std::vector<Vec2d> outline { pivot };
+    if (turn < 0.0)
+    {
+        append_join(pivot, n0, n1, 1.0, style, outline);
+    }
+    else
+    {
+        std::vector<Vec2d> chain;
+        append_join(pivot, n0, n1, -1.0, style, chain);
+        outline.insert(outline.end(), chain.rbegin(), chain.rend());
+    }
+
+    append_contour_edges(outline, edges);
+}
+
+void stroke_cap(const Vec2d end, const Vec2d from, const StrokeStyle &style, std::vector<Edge> &edges)
+{
+    if (end == from || style.width <= 0.0 || style.cap == LineCap::BUTT)
+    {
+        return;
+    }
+
+    Vec2d direction { (end - from).normalize() };
+    Vec2d normal { -direction.y, direction.x };
+    double half_width { style.width / 2.0 };
+
+    std::vector<Vec2d> outline { end + normal * half_width };
+    append_cap(end, direction, normal, style, outline);
+    outline.push_back(end - normal * half_width);
+
+    append_contour_edges(outline, edges);
+}
+
+}
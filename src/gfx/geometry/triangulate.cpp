@@ -1,4 +1,6 @@
 #include <gfx/geometry/triangulate.h>
+#include <algorithm>
+#include <cmath>
 #include <gfx/math/box2.h>
 
 namespace gfx::geometry
@@ -16,44 +18,116 @@ bool is_convex(const Triangle &triangle, const bool clockwise)
     return clockwise ? cross > 0 : cross < 0;
 }
 
-bool is_ear(const int index, const std::vector<int> &indices, const std::vector<Vec2d> &vertices, const Triangle &triangle, const int i0, const int i1, const int i2, const bool clockwise)
+struct RingNode
+{
+    int vertex;
+    int prev;
+    int next;
+    bool reflex;
+    bool removed;
+};
+
+// Uniform grid over the polygon bounds holding the vertices that are not strictly
+// convex. Only those can lie inside a convex ear, so ear tests only visit the cells
+// under the candidate triangle instead of every remaining vertex.
+class ReflexGrid
 {
-    if (!is_convex(triangle, clockwise))
-    {
-        return false;
-    }
 
-    for (int i = 0 ; i < indices.size(); ++i)
+public:
+
+    ReflexGrid(const std::vector<Vec2d> &vertices, const std::vector<RingNode> &nodes)
+        : vertices(vertices), nodes(nodes)
     {
-        if (i == i0 || i == i1 || i == i2)
+        bounds = Box2d { vertices[0], vertices[0] };
+        for (const auto &vertex : vertices)
         {
-            continue;
+            bounds.expand(vertex);
         }
 
-        Box2d bounds { triangle.v0, triangle.v0 };
-        for (auto v : { triangle.v1, triangle.v2 })
+        int num_reflex = 0;
+        for (const auto &node : nodes)
         {
-            bounds.expand(v);
+            num_reflex += node.reflex ? 1 : 0;
         }
 
-        Vec2d point { vertices[indices[i]] };
-        if (!bounds.contains(point))
-        {
-            continue;
-        }
+        dimensions = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(num_reflex))));
+        Vec2d size { bounds.size() };
+        inv_cell_size = Vec2d {
+            size.x > 0.0 ? dimensions / size.x : 0.0,
+            size.y > 0.0 ? dimensions / size.y : 0.0
+        };
 
-        if (point == triangle.v0 || point == triangle.v1 || point == triangle.v2)
+        cells.resize(dimensions * dimensions);
+        for (std::size_t i = 0; i < nodes.size(); ++i)
         {
-            continue;
+            if (nodes[i].reflex)
+            {
+                Vec2i cell { cell_of(vertices[nodes[i].vertex]) };
+                cells[cell.y * dimensions + cell.x].push_back(static_cast<int>(i));
+            }
         }
+    }
+
+    bool any_inside(const Triangle &triangle, const int i0, const int i1, const int i2) const
+    {
+        Box2d triangle_bounds { triangle.v0, triangle.v0 };
+        triangle_bounds.expand(triangle.v1);
+        triangle_bounds.expand(triangle.v2);
 
-        if (triangle.point_inside(point))
+        Vec2i min_cell { cell_of(triangle_bounds.min) };
+        Vec2i max_cell { cell_of(triangle_bounds.max) };
+
+        for (int y = min_cell.y; y <= max_cell.y; ++y)
         {
-            return false;
+            for (int x = min_cell.x; x <= max_cell.x; ++x)
+            {
+                for (int i : cells[y * dimensions + x])
+                {
+                    const RingNode &node { nodes[i] };
+                    if (!node.reflex || node.removed || i == i0 || i == i1 || i == i2)
+                    {
+                        continue;
+                    }
+
+                    Vec2d point { vertices[node.vertex] };
+                    if (!triangle_bounds.contains(point))
+                    {
+                        continue;
+                    }
+
+                    if (point == triangle.v0 || point == triangle.v1 || point == triangle.v2)
+                    {
+                        continue;
+                    }
+
+                    if (triangle.point_inside(point))
+                    {
+                        return true;
+                    }
+                }
+            }
         }
+        return false;
     }
-    return true;
-}
+
+private:
+
+    Vec2i cell_of(const Vec2d point) const
+    {
+        return Vec2i {
+            std::clamp(static_cast<int>((point.x - bounds.min.x) * inv_cell_size.x), 0, dimensions - 1),
+            std::clamp(static_cast<int>((point.y - bounds.min.y) * inv_cell_size.y), 0, dimensions - 1)
+        };
+    }
+
+    const std::vector<Vec2d> &vertices;
+    const std::vector<RingNode> &nodes;
+
+    Box2d bounds;
+    Vec2d inv_cell_size;
+    int dimensions;
+    std::vector<std::vector<int>> cells;
+};
 
 Contour merge_holes(const Contour &contour, const std::vector<Contour> &holes)
 {
@@ -72,9 +146,9 @@ Contour merge_holes(const Contour &contour, const std::vector<Contour> &holes)
                 ? (reversed = { hole.vertices.rbegin(), hole.vertices.rend() }, reversed)
                 : hole.vertices;
 
-        int hole_index = 0;
+        std::size_t hole_index = 0;
 
-        for (int i = 1; i < hole_vertices.size(); ++i)
+        for (std::size_t i = 1; i < hole_vertices.size(); ++i)
         {
             if (hole_vertices[i].x > hole_vertices[hole_index].x)
             {
@@ -88,7 +162,7 @@ Contour merge_holes(const Contour &contour, const std::vector<Contour> &holes)
         int best_edge = -1;
         Vec2d best_point;
 
-        for (int i = 0; i < merged.size(); ++i)
+        for (std::size_t i = 0; i < merged.size(); ++i)
         {
             Vec2d a = merged[i];
             Vec2d b = merged[(i + 1) % merged.size()];
@@ -99,7 +173,7 @@ Contour merge_holes(const Contour &contour, const std::vector<Contour> &holes)
                 if (x > bridge_start.x && x < best_x)
                 {
                     best_x = x;
-                    best_edge = i;
+                    best_edge = static_cast<int>(i);
                     best_point = { x, bridge_start.y };
                 }
             }
@@ -114,7 +188,7 @@ Contour merge_holes(const Contour &contour, const std::vector<Contour> &holes)
         new_merged.insert(new_merged.end(), merged.begin(), merged.begin() + best_edge + 1);
         new_merged.push_back(best_point);
 
-        for (int i = 0; i < hole_vertices.size(); ++i)
+        for (std::size_t i = 0; i < hole_vertices.size(); ++i)
         {
             new_merged.push_back(hole_vertices[(hole_index + i) % hole_vertices.size()]);
         }
@@ -129,56 +203,104 @@ Contour merge_holes(const Contour &contour, const std::vector<Contour> &holes)
     return Contour { merged, contour.clockwise };
 }
 
-std::vector<Triangle> triangulate_polygon(const gfx::geometry::types::Component &component)
+Triangulation triangulate_polygon_indexed(const gfx::geometry::types::Component &component)
 {
-    Contour merged;
-    auto& merged_contour = 
-        (component.holes.size() > 0)
-            ? (merged = { merge_holes(component.contour, component.holes) }, merged)
-            : component.contour;
+    Triangulation triangulation;
+    if (component.holes.size() > 0)
+    {
+        triangulation.vertices = merge_holes(component.contour, component.holes).vertices;
+    }
+    else
+    {
+        triangulation.vertices = component.contour.vertices;
+    }
 
-    const std::vector<Vec2d> &vertices { merged_contour.vertices };
-    const bool clockwise { merged_contour.clockwise };
+    const std::vector<Vec2d> &vertices { triangulation.vertices };
+    const bool clockwise { component.contour.clockwise };
 
-    std::vector<Triangle> triangles;
+    std::vector<std::array<int, 3>> &triangles { triangulation.indices };
     if (vertices.size() < 3)
     {
-        return triangles;
+        return triangulation;
     }
 
-    std::vector<int> indices;
-    indices.reserve(vertices.size());
-    for (int i = 0; i < vertices.size(); ++i)
+    int num_vertices { static_cast<int>(vertices.size()) };
+
+    std::vector<RingNode> nodes(num_vertices);
+    for (int i = 0; i < num_vertices; ++i)
     {
-        indices.push_back(i);
+        nodes[i] = RingNode { i, (i + num_vertices - 1) % num_vertices, (i + 1) % num_vertices, false, false };
     }
 
-    while (indices.size() > 3)
+    auto corner { [&](const int i) {
+        return Triangle { vertices[nodes[nodes[i].prev].vertex], vertices[nodes[i].vertex], vertices[nodes[nodes[i].next].vertex] };
+    } };
+
+    for (int i = 0; i < num_vertices; ++i)
     {
-        bool ear_found = false;
-        for (int i = 0; i < indices.size(); ++i)
+        nodes[i].reflex = !is_convex(corner(i), clockwise);
+    }
+
+    ReflexGrid grid { vertices, nodes };
+
+    triangles.reserve(num_vertices - 2);
+
+    int remaining { num_vertices };
+    int current { 0 };
+    int steps_without_ear { 0 };
+
+    while (remaining > 3)
+    {
+        RingNode &node { nodes[current] };
+        Triangle candidate { corner(current) };
+
+        if (!node.reflex && !grid.any_inside(candidate, node.prev, current, node.next))
         {
-            int prev_index { indices[(i == 0) ? indices.size() - 1 : i - 1] };
-            int cur_index { indices[i] };
-            int next_index { indices[(i + 1) >= indices.size() ? 0 : i + 1] };
+            triangles.push_back({ nodes[node.prev].vertex, node.vertex, nodes[node.next].vertex });
 
-            Triangle candidate { vertices[prev_index], vertices[cur_index], vertices[next_index] };
+            nodes[node.prev].next = node.next;
+            nodes[node.next].prev = node.prev;
+            node.removed = true;
+            --remaining;
 
-            if (is_ear(i, indices, vertices, candidate, prev_index, cur_index, next_index, clockwise))
+            // Clipping an ear can only turn its neighbours from reflex to convex.
+            for (int neighbour : { node.prev, node.next })
             {
-                triangles.push_back(candidate);
-                indices.erase(indices.begin() + i);
-                ear_found = true;
-                break;
+                if (nodes[neighbour].reflex)
+                {
+                    nodes[neighbour].reflex = !is_convex(corner(neighbour), clockwise);
+                }
             }
+
+            current = node.next;
+            steps_without_ear = 0;
+            continue;
         }
-        if (!ear_found)
+
+        if (++steps_without_ear > remaining)
         {
             triangles.clear();
-            return triangles;
+            return triangulation;
         }
+        current = node.next;
+    }
+
+    const RingNode &last { nodes[current] };
+    triangles.push_back({ nodes[last.prev].vertex, last.vertex, nodes[last.next].vertex });
+
+    return triangulation;
+}
+
+std::vector<Triangle> triangulate_polygon(const gfx::geometry::types::Component &component)
+{
+    Triangulation triangulation { triangulate_polygon_indexed(component) };
+
+    std::vector<Triangle> triangles;
+    triangles.reserve(triangulation.indices.size());
+    for (const auto &[i0, i1, i2] : triangulation.indices)
+    {
+        triangles.emplace_back(triangulation.vertices[i0], triangulation.vertices[i1], triangulation.vertices[i2]);
     }
-    triangles.emplace_back(vertices[indices[0]], vertices[indices[1]], vertices[indices[2]]);
 
     return triangles;
 }
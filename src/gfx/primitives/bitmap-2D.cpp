@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <gfx/primitives/bitmap-2D.h>
 #include <gfx/utils/transform.h>
 
@@ -13,8 +16,8 @@ Box2d Bitmap2D::get_geometry_size() const
     return Box2d { 
         { 0, 0 }, 
         { 
-            static_cast<double>(resolution.x), 
-            static_cast<double>(resolution.y) 
+            static_cast<double>(bitmap->resolution.x), 
+            static_cast<double>(bitmap->resolution.y) 
         } 
     };
 }
@@ -27,7 +30,7 @@ bool Bitmap2D::point_collides(const Vec2d point, const Matrix3x3d &transform) co
     int img_x = static_cast<int>(local_point.x);
     int img_y = static_cast<int>(local_point.y);
 
-    if (img_x >= 0 && img_x < resolution.x && img_y >= 0 && img_y < resolution.y)
+    if (img_x >= 0 && img_x < bitmap->resolution.x && img_y >= 0 && img_y < bitmap->resolution.y)
     {
         Color4 pixel { get_pixel({ img_x, img_y }) };
         return pixel.a > 0;
@@ -35,29 +38,373 @@ bool Bitmap2D::point_collides(const Vec2d point, const Matrix3x3d &transform) co
     return false;
 }
 
+static bool is_integer(const double value)
+{
+    return value == std::floor(value);
+}
+
+// Narrows [start, end] to the x where low <= origin + x * step < high.
+static void clip_span(const double origin, const double step, const double low, const double high, int &start, int &end)
+{
+    auto inside = [&](const int x) {
+        double value { step * x + origin };
+        return value >= low && value < high;
+    };
+
+    if (step == 0.0)
+    {
+        if (!inside(0))
+        {
+            end = start - 1;
+        }
+        return;
+    }
+
+    double enter { ((step > 0.0 ? low : high) - origin) / step };
+    double exit { ((step > 0.0 ? high : low) - origin) / step };
+    int first { static_cast<int>(std::clamp(std::ceil(enter), static_cast<double>(start), static_cast<double>(end) + 1.0)) };
+    int last { static_cast<int>(std::clamp(std::ceil(exit) - 1.0, static_cast<double>(start) - 1.0, static_cast<double>(end))) };
+
+    // The division can round across a boundary; settle the ends with the exact test.
+    while (first > start && inside(first - 1))
+    {
+        --first;
+    }
+    while (first <= last && !inside(first))
+    {
+        ++first;
+    }
+    while (last < end && inside(last + 1))
+    {
+        ++last;
+    }
+    while (last >= first && !inside(last))
+    {
+        --last;
+    }
+
+    start = first;
+    end = last;
+}
+
+template <BitmapLayout Layout>
+static Color4 sample_bilinear(const std::vector<Color4> &pixels, const Vec2i resolution, const int64_t u, const int64_t v)
+{
+    int x0 { static_cast<int>(u >> 16) };
+    int y0 { static_cast<int>(v >> 16) };
+    uint32_t fx { static_cast<uint32_t>(u >> 8) & 0xFF };
+    uint32_t fy { static_cast<uint32_t>(v >> 8) & 0xFF };
+
+    int left { std::clamp(x0, 0, resolution.x - 1) };
+    int right { std::clamp(x0 + 1, 0, resolution.x - 1) };
+    int top { std::clamp(y0, 0, resolution.y - 1) };
+    int bottom { std::clamp(y0 + 1, 0, resolution.y - 1) };
+
+    const Color4 &c00 { pixels[Bitmap::pixel_index<Layout>(resolution, left, top)] };
+    const Color4 &c10 { pixels[Bitmap::pixel_index<Layout>(resolution, right, top)] };
+    const Color4 &c01 { pixels[Bitmap::pixel_index<Layout>(resolution, left, bottom)] };
+    const Color4 &c11 { pixels[Bitmap::pixel_index<Layout>(resolution, right, bottom)] };
+
+    uint32_t w00 { (256 - fx) * (256 - fy) };
+    uint32_t w10 { fx * (256 - fy) };
+    uint32_t w01 { (256 - fx) * fy };
+    uint32_t w11 { fx * fy };
+
+    return Color4 {
+        static_cast<uint8_t>((c00.r * w00 + c10.r * w10 + c01.r * w01 + c11.r * w11 + 0x8000) >> 16),
+        static_cast<uint8_t>((c00.g * w00 + c10.g * w10 + c01.g * w01 + c11.g * w11 + 0x8000) >> 16),
+        static_cast<uint8_t>((c00.b * w00 + c10.b * w10 + c01.b * w01 + c11.b * w11 + 0x8000) >> 16),
+        static_cast<uint8_t>((c00.a * w00 + c10.a * w10 + c01.a * w01 + c11.a * w11 + 0x8000) >> 16)
+    };
+}
+
+static Color4 blend_levels(const Color4 &a, const Color4 &b, const uint32_t t)
+{
+    return Color4 {
+        static_cast<uint8_t>((a.r * (256 - t) + b.r * t + 0x80) >> 8),
+        static_cast<uint8_t>((a.g * (256 - t) + b.g * t + 0x80) >> 8),
+        static_cast<uint8_t>((a.b * (256 - t) + b.b * t + 0x80) >> 8),
+        static_cast<uint8_t>((a.a * (256 - t) + b.a * t + 0x80) >> 8)
+    };
+}
+
+void Bitmap2D::share_bitmap(const std::shared_ptr<Bitmap> &shared)
+{
+    if (!shared)
+    {
+        throw std::runtime_error { "Bitmap2D cannot share a null bitmap" };
+    }
+
+    bitmap = shared;
+    mipmaps.clear();
+    mipmaps_version = 0;
+    set_obb_dirty();
+}
+
+// The shared bitmap can be resized behind this primitive's back.
+void Bitmap2D::update_geometry() const
+{
+    if (geometry_resolution != bitmap->resolution)
+    {
+        geometry_resolution = bitmap->resolution;
+        obb_dirty = true;
+    }
+}
+
+const std::vector<Bitmap> &Bitmap2D::get_mipmaps() const
+{
+    if (bitmap->has_current_mipmaps())
+    {
+        return bitmap->mipmaps;
+    }
+
+    if (mipmaps_version != bitmap->get_version())
+    {
+        mipmaps = bitmap->make_mipmaps();
+        mipmaps_version = bitmap->get_version();
+    }
+    return mipmaps;
+}
+
+const std::vector<Color4> &Bitmap2D::get_level_pixels(const int level) const
+{
+    return level == 0 ? bitmap->pixels : get_mipmaps()[level - 1].pixels;
+}
+
+Vec2i Bitmap2D::get_level_resolution(const int level) const
+{
+    return level == 0 ? bitmap->resolution : get_mipmaps()[level - 1].resolution;
+}
+
+template <BitmapLayout Layout>
+void Bitmap2D::rasterize_integer_scaled(const Matrix3x3d &transform, const Box2i &bounds, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    int scale_x { static_cast<int>(transform(0, 0)) };
+    int scale_y { static_cast<int>(transform(1, 1)) };
+    int offset_x { static_cast<int>(transform(0, 2)) };
+    int offset_y { static_cast<int>(transform(1, 2)) };
+
+    int start_x { std::max(bounds.min.x, offset_x) };
+    int end_x { std::min(bounds.max.x, offset_x + bitmap->resolution.x * scale_x) };
+    int start_y { std::max(bounds.min.y, offset_y) };
+    int end_y { std::min(bounds.max.y, offset_y + bitmap->resolution.y * scale_y) };
+
+    for (int y = start_y; y < end_y; ++y)
+    {
+        int texel_y { (y - offset_y) / scale_y };
+
+        int texel { (start_x - offset_x) / scale_x };
+        int repeat { scale_x - (start_x - offset_x) % scale_x };
+
+        for (int x = start_x; x < end_x; ++x)
+        {
+            const Color4 &color { bitmap->pixels[Bitmap::pixel_index<Layout>(bitmap->resolution, texel, texel_y)] };
+            if (color.a > 0)
+            {
+                emit_pixel(Pixel { { x, y }, color });
+            }
+
+            if (--repeat == 0)
+            {
+                ++texel;
+                repeat = scale_x;
+            }
+        }
+    }
+}
+
 void Bitmap2D::rasterize(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    if (bitmap->resolution.x <= 0 || bitmap->resolution.y <= 0 || bitmap->pixels.empty())
+    {
+        return;
+    }
+
+    update_geometry();
+    if (bitmap->layout == BitmapLayout::TILED)
+    {
+        rasterize_layout<BitmapLayout::TILED>(transform, emit_pixel);
+    }
+    else
+    {
+        rasterize_layout<BitmapLayout::ROW_MAJOR>(transform, emit_pixel);
+    }
+}
+
+template <BitmapLayout Layout>
+void Bitmap2D::rasterize_layout(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
 {
     Box2d AABB { get_axis_aligned_bounding_box(transform) };
+    Box2i bounds {
+        { static_cast<int>(AABB.min.x), static_cast<int>(AABB.min.y) },
+        { static_cast<int>(AABB.max.x), static_cast<int>(AABB.max.y) }
+    };
+
+    bool axis_aligned { transform(0, 1) == 0.0 && transform(1, 0) == 0.0 };
+    if (filter == BitmapFilter::NEAREST && axis_aligned &&
+        transform(0, 0) >= 1.0 && transform(1, 1) >= 1.0 &&
+        is_integer(transform(0, 0)) && is_integer(transform(1, 1)) &&
+        is_integer(transform(0, 2)) && is_integer(transform(1, 2)))
+    {
+        rasterize_integer_scaled<Layout>(transform, bounds, emit_pixel);
+        return;
+    }
+
     Matrix3x3d inverse_transform { utils::invert_affine(transform) };
 
-    for (int y = static_cast<int>(AABB.min.y); y < static_cast<int>(AABB.max.y); ++y)
+    // Level of detail from the number of texels one screen pixel steps over.
+    double footprint {
+        std::max(
+            std::hypot(inverse_transform(0, 0), inverse_transform(1, 0)),
+            std::hypot(inverse_transform(0, 1), inverse_transform(1, 1))
+        )
+    };
+
+    if (mipmap_mode == MipmapMode::NONE || footprint <= 1.0)
     {
-        for (int x = static_cast<int>(AABB.min.x); x < static_cast<int>(AABB.max.x); ++x)
-        {
-            Vec2d pos { static_cast<double>(x), static_cast<double>(y) };
-            Vec2d local_pos = utils::transform_point(pos, inverse_transform);
+        rasterize_level<Layout>(inverse_transform, 0, bounds, emit_pixel);
+        return;
+    }
+
+    int max_level { static_cast<int>(get_mipmaps().size()) };
+    double lod { std::log2(footprint) };
+
+    if (mipmap_mode == MipmapMode::NEAREST)
+    {
+        rasterize_level<Layout>(inverse_transform, std::min(static_cast<int>(lod + 0.5), max_level), bounds, emit_pixel);
+        return;
+    }
+
+    int level { std::min(static_cast<int>(lod), max_level) };
+    double blend { lod - level };
+    if (level == max_level || blend < 1.0 / 256.0)
+    {
+        rasterize_level<Layout>(inverse_transform, level, bounds, emit_pixel);
+        return;
+    }
+    rasterize_trilinear<Layout>(inverse_transform, level, blend, bounds, emit_pixel);
+}
 
-            int img_x = static_cast<int>(local_pos.x);
-            int img_y = static_cast<int>(local_pos.y);
+template <BitmapLayout Layout>
+void Bitmap2D::rasterize_level(const Matrix3x3d &inverse_transform, const int level, const Box2i &bounds, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    const std::vector<Color4> &texels { get_level_pixels(level) };
+    Vec2i size { get_level_resolution(level) };
+
+    // Level texel coordinates cover the same extent as the full resolution bitmap.
+    double scale_x { static_cast<double>(size.x) / bitmap->resolution.x };
+    double scale_y { static_cast<double>(size.y) / bitmap->resolution.y };
+    double du { inverse_transform(0, 0) * scale_x };
+    double dv { inverse_transform(1, 0) * scale_y };
+
+    for (int y = bounds.min.y; y < bounds.max.y; ++y)
+    {
+        // Source coordinates at x = 0 on this row; they advance by (du, dv) per pixel.
+        double u0 { (inverse_transform(0, 1) * y + inverse_transform(0, 2)) * scale_x };
+        double v0 { (inverse_transform(1, 1) * y + inverse_transform(1, 2)) * scale_y };
+
+        int start { bounds.min.x };
+        int end { bounds.max.x - 1 };
+        clip_span(u0, du, 0.0, size.x, start, end);
+        clip_span(v0, dv, 0.0, size.y, start, end);
 
-            if (img_x >= 0 && img_x < resolution.x && img_y >= 0 && img_y < resolution.y)
+        if (filter == BitmapFilter::BILINEAR)
+        {
+            // Bilinear sampling steps in 16.16 fixed point, centred on texel midpoints.
+            int64_t u { std::llround((du * start + u0 - 0.5) * 65536.0) };
+            int64_t v { std::llround((dv * start + v0 - 0.5) * 65536.0) };
+            int64_t step_u { std::llround(du * 65536.0) };
+            int64_t step_v { std::llround(dv * 65536.0) };
+
+            for (int x = start; x <= end; ++x, u += step_u, v += step_v)
             {
-                Color4 pixel { get_pixel({ img_x, img_y }) };
-                if (pixel.a > 0)
+                Color4 color { sample_bilinear<Layout>(texels, size, u, v) };
+                if (color.a > 0)
                 {
-                    emit_pixel(Pixel { { x, y }, pixel });
+                    emit_pixel(Pixel { { x, y }, color });
                 }
             }
+            continue;
+        }
+
+        for (int x = start; x <= end; ++x)
+        {
+            double u { du * x + u0 };
+            double v { dv * x + v0 };
+
+            int img_x { std::clamp(static_cast<int>(u), 0, size.x - 1) };
+            int img_y { std::clamp(static_cast<int>(v), 0, size.y - 1) };
+            const Color4 &color { texels[Bitmap::pixel_index<Layout>(size, img_x, img_y)] };
+
+            if (color.a > 0)
+            {
+                emit_pixel(Pixel { { x, y }, color });
+            }
+        }
+    }
+}
+
+template <BitmapLayout Layout>
+void Bitmap2D::rasterize_trilinear(const Matrix3x3d &inverse_transform, const int level, const double blend, const Box2i &bounds, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    const std::vector<Color4> &fine_texels { get_level_pixels(level) };
+    const std::vector<Color4> &coarse_texels { get_level_pixels(level + 1) };
+    Vec2i fine_size { get_level_resolution(level) };
+    Vec2i coarse_size { get_level_resolution(level + 1) };
+
+    double fine_scale_x { static_cast<double>(fine_size.x) / bitmap->resolution.x };
+    double fine_scale_y { static_cast<double>(fine_size.y) / bitmap->resolution.y };
+    double coarse_scale_x { static_cast<double>(coarse_size.x) / bitmap->resolution.x };
+    double coarse_scale_y { static_cast<double>(coarse_size.y) / bitmap->resolution.y };
+
+    double du { inverse_transform(0, 0) };
+    double dv { inverse_transform(1, 0) };
+    uint32_t weight { static_cast<uint32_t>(blend * 256.0) };
+
+    auto to_fixed = [](const double value) { return std::llround(value * 65536.0); };
+
+    for (int y = bounds.min.y; y < bounds.max.y; ++y)
+    {
+        double u0 { inverse_transform(0, 1) * y + inverse_transform(0, 2) };
+        double v0 { inverse_transform(1, 1) * y + inverse_transform(1, 2) };
+
+        int start { bounds.min.x };
+        int end { bounds.max.x - 1 };
+        clip_span(u0, du, 0.0, bitmap->resolution.x, start, end);
+        clip_span(v0, dv, 0.0, bitmap->resolution.y, start, end);
+
+        double u { du * start + u0 };
+        double v { dv * start + v0 };
+
+        int64_t fine_u { to_fixed(u * fine_scale_x - 0.5) };
+        int64_t fine_v { to_fixed(v * fine_scale_y - 0.5) };
+        int64_t coarse_u { to_fixed(u * coarse_scale_x - 0.5) };
+        int64_t coarse_v { to_fixed(v * coarse_scale_y - 0.5) };
+
+        int64_t fine_step_u { to_fixed(du * fine_scale_x) };
+        int64_t fine_step_v { to_fixed(dv * fine_scale_y) };
+        int64_t coarse_step_u { to_fixed(du * coarse_scale_x) };
+        int64_t coarse_step_v { to_fixed(dv * coarse_scale_y) };
+
+        for (int x = start; x <= end; ++x)
+        {
+            Color4 color {
+                blend_levels(
+                    sample_bilinear<Layout>(fine_texels, fine_size, fine_u, fine_v),
+                    sample_bilinear<Layout>(coarse_texels, coarse_size, coarse_u, coarse_v),
+                    weight
+                )
+            };
+
+            if (color.a > 0)
+            {
+                emit_pixel(Pixel { { x, y }, color });
+            }
+
+            fine_u += fine_step_u;
+            fine_v += fine_step_v;
+            coarse_u += coarse_step_u;
+            coarse_v += coarse_step_v;
         }
     }
 }
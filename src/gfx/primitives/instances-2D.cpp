@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <numeric>
+#include <gfx/primitives/instances-2D.h>
+#include <gfx/utils/transform.h>
+
+namespace gfx::primitives
+{
+
+using namespace gfx::core;
+using namespace gfx::core::types;
+using namespace gfx::math;
+
+
+Vec2d Instances2D::get_anchor_offset() const
+{
+    return prototype->get_anchor() * prototype->get_geometry_size().size();
+}
+
+Matrix3x3d Instances2D::get_instance_transform(const Instance2D &instance) const
+{
+    return get_instance_transform(instance, get_anchor_offset());
+}
+
+Matrix3x3d Instances2D::get_instance_transform(const Instance2D &instance, const Vec2d anchor_offset)
+{
+    double c { std::cos(instance.rotation) };
+    double s { std::sin(instance.rotation) };
+
+    // translate(position) * rotate(rotation) * scale(scale) * translate(-anchor_offset), expanded.
+    Matrix3x3d result {
+        { c * instance.scale.x, -s * instance.scale.y, 0.0 },
+        { s * instance.scale.x, c * instance.scale.y, 0.0 },
+        { 0.0, 0.0, 1.0 }
+    };
+    result(0, 2) = instance.position.x - result(0, 0) * anchor_offset.x - result(0, 1) * anchor_offset.y;
+    result(1, 2) = instance.position.y - result(1, 0) * anchor_offset.x - result(1, 1) * anchor_offset.y;
+
+    return result;
+}
+
+Box2d Instances2D::get_geometry_size() const
+{
+    if (!bounds_dirty)
+    {
+        return cached_bounds;
+    }
+
+    cached_bounds = Box2d { Vec2d::zero(), Vec2d::zero() };
+    if (prototype && !instances.empty())
+    {
+        // The template's local box is the same for every instance; only its corners are moved.
+        Vec2d anchor_offset { get_anchor_offset() };
+        std::vector<Vec2d> corners { prototype->get_axis_aligned_bounding_box(Matrix3x3d::identity()).get_corners() };
+
+        Vec2d first { utils::transform_point(corners[0], get_instance_transform(instances[0], anchor_offset)) };
+        cached_bounds = Box2d { first, first };
+        for (const auto &instance : instances)
+        {
+            Matrix3x3d instance_transform { get_instance_transform(instance, anchor_offset) };
+            for (const auto &corner : corners)
+            {
+                cached_bounds.expand(utils::transform_point(corner, instance_transform));
+            }
+        }
+    }
+    bounds_dirty = false;
+
+    return cached_bounds;
+}
+
+bool Instances2D::point_collides(const Vec2d point, const Matrix3x3d &transform) const
+{
+    if (!prototype)
+    {
+        return false;
+    }
+
+    Vec2d anchor_offset { get_anchor_offset() };
+    return std::any_of(instances.begin(), instances.end(), [&](const Instance2D &instance) {
+        return prototype->point_collides(point, transform * get_instance_transform(instance, anchor_offset));
+    });
+}
+
+void Instances2D::rasterize(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    if (!prototype || instances.empty())
+    {
+        return;
+    }
+
+    if (order_dirty)
+    {
+        draw_order.resize(instances.size());
+        std::iota(draw_order.begin(), draw_order.end(), 0);
+        std::stable_sort(draw_order.begin(), draw_order.end(), [&](const size_t a, const size_t b) {
+            return instances[a].depth < instances[b].depth;
+        });
+        order_dirty = false;
+    }
+
+    // The template keeps its local-space caches across instances; only the color is swapped.
+    Color4 instance_color;
+    std::function<void(const Pixel&)> emit_instance_pixel { [&](const Pixel &pixel) {
+        Color4 color { instance_color };
+        color.a = static_cast<uint8_t>(pixel.color.a * instance_color.a / 255);
+        emit_pixel(Pixel { pixel.position, color });
+    } };
+
+    Vec2d anchor_offset { get_anchor_offset() };
+    for (const size_t index : draw_order)
+    {
+        const Instance2D &instance { instances[index] };
+        instance_color = instance.color;
+        prototype->rasterize(transform * get_instance_transform(instance, anchor_offset), emit_instance_pixel);
+    }
+}
+
+}
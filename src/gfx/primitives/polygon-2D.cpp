@@ -2,6 +2,7 @@
 #include <gfx/utils/transform.h>
 #include <gfx/geometry/triangulate.h>
 #include <gfx/geometry/rasterize.h>
+#include <gfx/geometry/scanline.h>
 
 
 namespace gfx::primitives
@@ -41,38 +42,55 @@ bool Polygon2D::point_collides(const Vec2d point, const Matrix3x3d &transform) c
     return false;
 }
 
-void Polygon2D::rasterize_component(const Component &component, const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+const Triangulation &Polygon2D::get_triangulation(const int component) const
 {
-    std::vector<Contour> transformed_holes;
-    for (const auto &hole : component.holes)
+    if (cached_triangulations.size() < components.size())
+    {
+        cached_triangulations.resize(components.size());
+        triangulations_dirty.resize(components.size(), true);
+    }
+    if (triangulations_dirty[component])
     {
-        transformed_holes.push_back(Contour { 
-            utils::transform_points(hole.vertices, transform),
-            hole.clockwise 
-        });
+        cached_triangulations[component] = geometry::triangulate_polygon_indexed(components[component]);
+        triangulations_dirty[component] = false;
     }
+    return cached_triangulations[component];
+}
 
-    Component transformed_component { 
-        utils::transform_points(component.contour.vertices, transform),
-        component.contour.clockwise,
-        transformed_holes
-    };
+void Polygon2D::rasterize_component(const Triangulation &triangulation, const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    std::vector<Vec2d> vertices { utils::transform_points(triangulation.vertices, transform) };
 
-    std::vector<Triangle> triangles { 
-        geometry::triangulate_polygon(transformed_component)
-    };
+    for (const auto &[i0, i1, i2] : triangulation.indices)
+    {
+        geometry::rasterize_filled_triangle({ vertices[i0], vertices[i1], vertices[i2] }, color, emit_pixel);
+    }
+}
 
-    for (auto triangle : triangles)
+void Polygon2D::rasterize_component_scanline(const Component &component, const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    std::vector<Edge> edges;
+    append_contour_edges(utils::transform_points(component.contour.vertices, transform), edges);
+    for (const auto &hole : component.holes)
     {
-        geometry::rasterize_filled_triangle(triangle, color, emit_pixel);
+        append_contour_edges(utils::transform_points(hole.vertices, transform), edges);
     }
+
+    geometry::rasterize_filled_edges(edges, fill_rule, color, emit_pixel);
 }
 
 void Polygon2D::rasterize(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
 {
-    for (const auto &component : components)
+    for (std::size_t i = 0; i < components.size(); ++i)
     {
-        rasterize_component(component, transform, emit_pixel);
+        // Ear clipping yields nothing for self-intersecting outlines; the scanline
+        // filler handles those under the configured fill rule.
+        if (fill_method == FillMethod::TRIANGLES && !get_triangulation(i).indices.empty())
+        {
+            rasterize_component(get_triangulation(i), transform, emit_pixel);
+            continue;
+        }
+        rasterize_component_scanline(components[i], transform, emit_pixel);
     }
 }
 
@@ -104,52 +122,64 @@ bool Polygon2D::cache_clockwise_hole(const int component, const int hole)
     return contour.clockwise;
 }
 
+// New components get a dirty cache entry on the next lookup. A new hole changes the
+// component it belongs to even when the caller then has nothing to set.
+void Polygon2D::ensure_component(const int component)
+{
+    if (static_cast<std::size_t>(component) >= components.size())
+    {
+        components.resize(component + 1);
+    }
+}
+
+void Polygon2D::ensure_hole(const int component, const int hole)
+{
+    ensure_component(component);
+    if (static_cast<std::size_t>(hole) >= components[component].holes.size())
+    {
+        components[component].holes.resize(hole + 1);
+        set_triangulation_dirty(component);
+    }
+}
+
 void Polygon2D::add_vertex(const gfx::math::Vec2d vertex, const int component) 
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
+    ensure_component(component);
     components[component].contour.vertices.push_back(vertex); 
     cache_clockwise(component); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
 void Polygon2D::add_vertices(const std::vector<gfx::math::Vec2d> &new_vertices, const int component)
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
+    ensure_component(component);
     std::vector<gfx::math::Vec2d> &points { components[component].contour.vertices };
     points.insert(points.end(), new_vertices.begin(), new_vertices.end()); 
     cache_clockwise(component); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
 void Polygon2D::set_vertex(const size_t index, const gfx::math::Vec2d vertex, const int component)
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
+    ensure_component(component);
     std::vector<gfx::math::Vec2d> &points { components[component].contour.vertices };
     if (index < points.size()) 
     { 
         points[index] = vertex; 
         cache_clockwise(component);
+        set_triangulation_dirty(component);
         set_obb_dirty();
     } 
 }
 
 void Polygon2D::set_vertices(const std::vector<gfx::math::Vec2d> &new_vertices, const int component)
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
+    ensure_component(component);
     components[component].contour.vertices = new_vertices; 
     cache_clockwise(component); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
@@ -160,6 +190,7 @@ void Polygon2D::clear_vertices(const int component)
         return;
     }
     components[component].contour.vertices.clear(); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
@@ -174,62 +205,42 @@ std::vector<gfx::math::Vec2d> Polygon2D::get_vertices(const int component) const
 
 void Polygon2D::add_hole_vertex(const gfx::math::Vec2d vertex, const int component, const int hole) 
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
+    ensure_hole(component, hole);
     components[component].holes[hole].vertices.push_back(vertex); 
     cache_clockwise_hole(component, hole); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
 void Polygon2D::add_hole_vertices(const std::vector<gfx::math::Vec2d> &new_vertices, const int component, const int hole)
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
-    if (hole >= components[component].holes.size())
-    {
-        components[component].holes.resize(hole + 1);
-    }
+    ensure_hole(component, hole);
     std::vector<gfx::math::Vec2d> &points { components[component].holes[hole].vertices };
     points.insert(points.end(), new_vertices.begin(), new_vertices.end()); 
     cache_clockwise_hole(component, hole); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
 void Polygon2D::set_hole_vertex(const size_t index, const gfx::math::Vec2d vertex, const int component, const int hole)
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
-    if (hole >= components[component].holes.size())
-    {
-        components[component].holes.resize(hole + 1);
-    }
+    ensure_hole(component, hole);
     std::vector<gfx::math::Vec2d> &points { components[component].holes[hole].vertices };
-    if (component < points.size()) 
+    if (index < points.size()) 
     { 
         points[index] = vertex; 
         cache_clockwise_hole(component, hole); 
+        set_triangulation_dirty(component);
         set_obb_dirty();
     } 
 }
 
 void Polygon2D::set_hole_vertices(const std::vector<gfx::math::Vec2d> &new_vertices, const int component, const int hole)
 { 
-    if (component >= components.size()) 
-    { 
-        components.resize(component + 1); 
-    }
-    if (hole >= components[component].holes.size())
-    {
-        components[component].holes.resize(hole + 1);
-    }
+    ensure_hole(component, hole);
     components[component].holes[hole].vertices = new_vertices;
     cache_clockwise_hole(component, hole); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
@@ -244,6 +255,7 @@ void Polygon2D::clear_hole_vertices(const int component, const int hole)
         return;
     }
     components[component].holes[hole].vertices.clear(); 
+    set_triangulation_dirty(component); 
     set_obb_dirty(); 
 }
 
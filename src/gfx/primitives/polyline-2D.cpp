@@ -1,8 +1,11 @@
+#include <algorithm>
 #include <numbers>
 #include <gfx/primitives/polyline-2D.h>
 #include <gfx/utils/transform.h>
 #include <gfx/geometry/triangulate.h>
 #include <gfx/geometry/rasterize.h>
+#include <gfx/geometry/scanline.h>
+#include <gfx/geometry/simplify.h>
 
 namespace gfx::primitives
 {
@@ -29,7 +32,10 @@ Box2d Polyline2D::get_geometry_size() const
 Box2d Polyline2D::get_axis_aligned_bounding_box(const Matrix3x3d &transform) const
 {
     Box2d extent { get_geometry_size() };
-    Vec2d line_extent { std::ceil(line_thickness / 2.0), std::ceil(line_thickness / 2.0) };
+    // Miter spikes reach up to miter_limit half-widths from the vertex, square caps sqrt(2).
+    double reach { stroke_style.join == LineJoin::MITER ? std::max(stroke_style.miter_limit, std::numbers::sqrt2) : std::numbers::sqrt2 };
+    double half_extent { std::ceil(stroke_style.width / 2.0 * reach) };
+    Vec2d line_extent { half_extent, half_extent };
     Vec2d top_left { extent.min - line_extent };
     Vec2d bot_right { extent.max + line_extent };
 
@@ -53,78 +59,373 @@ bool Polyline2D::point_collides(const Vec2d point, const Matrix3x3d &transform)
     return false;
 }
 
-void Polyline2D::rasterize_rounded_corner(const Vec2d pos, const double angle0, const double angle1, const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+void Polyline2D::push_point(const Vec2d point)
 {
-    std::vector<Vec2d> vertices;
+    if (max_points > 0 && points.size() >= max_points)
+    {
+        pop_front();
+    }
+
+    points.push_back(point);
+    if (segments_visible.size() + 1 == points.size())
+    {
+        segments_visible.push_back(true);
+    }
+
+    if (!stroke_dirty)
+    {
+        segment_strokes.emplace_back();
+        invalidate_segment(points.size() - 2);
+        invalidate_repeated_segments(0);
+    }
+
+    set_fill_dirty();
+    set_obb_dirty();
+}
+
+void Polyline2D::pop_front()
+{
+    if (points.empty())
+    {
+        return;
+    }
+
+    points.pop_front();
+    if (!segments_visible.empty())
+    {
+        segments_visible.pop_front();
+    }
+
+    if (!stroke_dirty)
+    {
+        segment_strokes.pop_front();
+        invalidate_repeated_segments(0);
+        invalidate_segment(points.size() - 1);
+    }
+
+    set_fill_dirty();
+    set_obb_dirty();
+}
+
+void Polyline2D::add_points(const std::vector<Vec2d> &new_points)
+{
+    points.insert(points.end(), new_points.begin(), new_points.end());
+    set_stroke_dirty();
+    set_fill_dirty();
+    set_obb_dirty();
+}
+
+void Polyline2D::set_point(const size_t index, const Vec2d point)
+{
+    if (index >= points.size())
+    {
+        return;
+    }
+
+    points[index] = point;
+
+    if (!stroke_dirty)
+    {
+        // The segments on either side and the joins at both of their ends.
+        invalidate_segment(index + points.size() - 1);
+        invalidate_segment(index);
+        invalidate_repeated_segments(index + 1);
+    }
 
-    for (int i = 0; i <= CORNER_SEGMENTS; ++i)
+    set_fill_dirty();
+    set_obb_dirty();
+}
+
+void Polyline2D::set_points(const std::vector<Vec2d> &new_points)
+{
+    points.assign(new_points.begin(), new_points.end());
+    set_stroke_dirty();
+    set_fill_dirty();
+    set_obb_dirty();
+}
+
+void Polyline2D::clear_points()
+{
+    points.clear();
+    segments_visible.clear();
+    set_stroke_dirty();
+    set_fill_dirty();
+    set_obb_dirty();
+}
+
+void Polyline2D::invalidate_segment(const size_t index)
+{
+    if (!segment_strokes.empty())
     {
-        double progress { static_cast<double>(i) / static_cast<double>(CORNER_SEGMENTS) };
-        double theta { angle0 + (angle1 - angle0) * progress };
+        segment_strokes[index % segment_strokes.size()].valid = false;
+    }
+}
 
-        Vec2d vertex {
-            pos.x + (line_thickness / 2.0) * std::cos(theta),
-            pos.y + (line_thickness / 2.0) * std::sin(theta)
-        };
+// Joins look back past repeated points, so a segment's join also changes with the point
+// before a run of segments that start on the same position as it.
+void Polyline2D::invalidate_repeated_segments(const size_t first)
+{
+    size_t count { points.size() };
+    if (segment_strokes.empty() || count == 0)
+    {
+        return;
+    }
 
-        vertices.push_back(utils::transform_point(vertex, transform));
+    Vec2d start { points[first % count] };
+    invalidate_segment(first);
+    for (size_t step = 1; step < count && points[(first + step) % count] == start; ++step)
+    {
+        invalidate_segment(first + step);
     }
-    Vec2d transformed_pos = utils::transform_point(pos, transform);
+}
 
-    for (int i = 0; i < vertices.size() - 1; ++i)
+void Polyline2D::build_segment_stroke(const size_t index, const StrokeStyle &style) const
+{
+    size_t count { points.size() };
+    SegmentStroke &stroke { segment_strokes[index] };
+
+    // Repeated points have no direction, so like stroke_polyline the join looks back to the
+    // last point that differs. rasterize_stroke only uses it when that segment exists.
+    Vec2d pivot { points[index] };
+    size_t previous { (index + count - 1) % count };
+    for (size_t step = 1; step < count && points[previous] == pivot; ++step)
     {
-        geometry::rasterize_filled_triangle({ transformed_pos, vertices[i], vertices[i + 1] }, color, emit_pixel);
+        previous = (previous + count - 1) % count;
     }
+
+    stroke.body.clear();
+    stroke.join.clear();
+    stroke_segment(pivot, points[(index + 1) % count], style, stroke.body);
+    stroke_join(points[previous], pivot, points[(index + 1) % count], style, stroke.join);
+    stroke.valid = true;
 }
 
-void Polyline2D::rasterize_rounded_corners(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+void Polyline2D::rasterize_stroke(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
 {
-    for (int i = 0; i < points.size(); ++i)
+    Vec2d scale { utils::extract_scale(transform) };
+    double max_scale { std::max(std::abs(scale.x), std::abs(scale.y)) };
+    double tolerance { max_scale > 0.0 ? 0.25 / max_scale : 0.25 };
+
+    // Only round joins depend on the flattening tolerance; caps are rebuilt every frame.
+    bool round_joins { stroke_style.join == LineJoin::ROUND };
+    if (stroke_dirty || segment_strokes.size() != points.size() || (round_joins && tolerance != cached_stroke_tolerance))
+    {
+        segment_strokes.assign(points.size(), SegmentStroke {});
+        cached_stroke_tolerance = tolerance;
+        stroke_dirty = false;
+    }
+
+    StrokeStyle style { stroke_style };
+    style.tolerance = tolerance;
+
+    size_t count { points.size() };
+    size_t num_segments { do_close ? count : count - 1 };
+    auto visible = [&](const size_t segment) {
+        return segment >= segments_visible.size() || segments_visible[segment];
+    };
+    auto degenerate = [&](const size_t segment) {
+        return points[segment] == points[(segment + 1) % count];
+    };
+
+    // Zero length segments are skipped like repeated points in stroke_polyline, so a segment
+    // joins the nearest non-degenerate neighbour as long as no hidden segment is in between.
+    auto connected = [&](const size_t segment, const bool forward) {
+        size_t current { segment };
+        for (size_t step = 1; step < count; ++step)
+        {
+            if (!do_close && (forward ? current + 1 >= num_segments : current == 0))
+            {
+                return false;
+            }
+
+            current = forward ? (current + 1) % count : (current + count - 1) % count;
+            if (!visible(current))
+            {
+                return false;
+            }
+            if (!degenerate(current))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<Edge> local_edges;
+    std::vector<Edge> edges;
+
+    auto append_transformed = [&](const std::vector<Edge> &source) {
+        for (const auto &edge : source)
+        {
+            edges.push_back({ utils::transform_point(edge.v0, transform), utils::transform_point(edge.v1, transform) });
+        }
+    };
+
+    // Hidden segments split the line into runs; runs get caps where they end.
+    for (size_t i = 0; i < num_segments; ++i)
     {
-        Vec2d p0 { points[(i - 1 + points.size()) % points.size()] };
-        Vec2d p1 { points[i] };
-        Vec2d p2 { points[(i + 1) % points.size()] };
+        if (!visible(i) || degenerate(i))
+        {
+            continue;
+        }
 
-        Vec2d normal0 { (p0 - p1).normal().normalize() };
-        Vec2d normal1 { (p1 - p2).normal().normalize() };
+        if (!segment_strokes[i].valid)
+        {
+            build_segment_stroke(i, style);
+        }
+        append_transformed(segment_strokes[i].body);
 
-        Vec2d between { ((p1 - p0) + (p1 - p2)).normalize() };
+        bool has_previous { connected(i, false) };
+        bool has_next { connected(i, true) };
+        Vec2d start { points[i] };
+        Vec2d end { points[(i + 1) % count] };
 
-        double angle0 { std::atan2(normal0.y, normal0.x) };
-        double angle1 { std::atan2(normal1.y, normal1.x) };
+        if (has_previous)
+        {
+            append_transformed(segment_strokes[i].join);
+        }
+        else
+        {
+            local_edges.clear();
+            stroke_cap(start, end, style, local_edges);
+            append_transformed(local_edges);
+        }
 
-        double angle_diff { angle1 - angle0 };
-        if (angle_diff <= 0) 
+        if (!has_next)
         {
-            angle_diff += 2 * std::numbers::pi;
+            local_edges.clear();
+            stroke_cap(end, start, style, local_edges);
+            append_transformed(local_edges);
         }
+    }
 
-        double angle_overlap = 0.1;
-        double pos_overlap = 0.2;
+    geometry::rasterize_filled_edges(edges, FillRule::NON_ZERO, color, emit_pixel);
+}
 
-        rasterize_rounded_corner(p1 - between * pos_overlap, angle0 - angle_overlap, angle0 + angle_diff + angle_overlap, transform, emit_pixel);
+static bool same_transform(const Matrix3x3d &a, const Matrix3x3d &b)
+{
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            if (a(r, c) != b(r, c))
+            {
+                return false;
+            }
+        }
     }
+    return true;
 }
 
-void Polyline2D::rasterize_edge(const Vec2d start, const Vec2d end, const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+void Polyline2D::build_simplified_stroke(const Matrix3x3d &transform) const
 {
-    double line_extent { line_thickness / 2.0 };
-    Vec2d normal { (end - start).normal().normalize() };
+    cached_simplified_edges.clear();
+    cached_simplified_transform = transform;
+    simplified_dirty = false;
+
+    Vec2d scale { utils::extract_scale(transform) };
+    double max_scale { std::max(std::abs(scale.x), std::abs(scale.y)) };
+
+    StrokeStyle style { stroke_style };
+    style.tolerance = max_scale > 0.0 ? 0.25 / max_scale : 0.25;
+
+    size_t count { points.size() };
+    size_t num_segments { do_close ? count : count - 1 };
+    auto visible = [&](const size_t segment) {
+        return segment >= segments_visible.size() || segments_visible[segment];
+    };
+
+    std::vector<size_t> run;
+    std::vector<Vec2d> screen_points;
+    std::vector<size_t> kept;
+    std::vector<Vec2d> local_points;
+    std::vector<Edge> local_edges;
+
+    // Runs are simplified against their screen positions, then the kept points are
+    // stroked in local space so non-uniform scales still widen the line correctly.
+    auto flush_run = [&](const bool closed) {
+        if (run.size() < 2)
+        {
+            run.clear();
+            return;
+        }
+
+        screen_points.clear();
+        for (const size_t index : run)
+        {
+            screen_points.push_back(utils::transform_point(points[index], transform));
+        }
+
+        kept.clear();
+        simplify_polyline(screen_points, simplify_tolerance, kept);
+
+        local_points.clear();
+        for (const size_t index : kept)
+        {
+            local_points.push_back(points[run[index]]);
+        }
+        if (closed)
+        {
+            local_points.pop_back();
+        }
+
+        stroke_polyline(local_points, closed, style, local_edges);
+        run.clear();
+    };
 
-    Vec2d offset { normal * line_extent };
+    size_t start { 0 };
+    while (start < num_segments && visible(start))
+    {
+        ++start;
+    }
 
-    Vec2d v0 { start + offset };
-    Vec2d v1 { start - offset };
-    Vec2d v2 { end + offset };
-    Vec2d v3 { end - offset };
+    if (start == num_segments)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            run.push_back(i);
+        }
+        if (do_close)
+        {
+            run.push_back(0);
+        }
+        flush_run(do_close);
+    }
+    else
+    {
+        for (size_t i = 0; i < num_segments; ++i)
+        {
+            size_t segment { do_close ? (start + 1 + i) % num_segments : i };
+            if (!visible(segment))
+            {
+                flush_run(false);
+                continue;
+            }
+
+            if (run.empty())
+            {
+                run.push_back(segment);
+            }
+            run.push_back((segment + 1) % count);
+        }
+        flush_run(false);
+    }
 
-    v0 = utils::transform_point(v0, transform);
-    v1 = utils::transform_point(v1, transform);
-    v2 = utils::transform_point(v2, transform);
-    v3 = utils::transform_point(v3, transform);
+    cached_simplified_edges.reserve(local_edges.size());
+    for (const auto &edge : local_edges)
+    {
+        cached_simplified_edges.push_back({ utils::transform_point(edge.v0, transform), utils::transform_point(edge.v1, transform) });
+    }
+}
 
-    geometry::rasterize_filled_triangle({ v0, v1, v2 }, color, emit_pixel);
-    geometry::rasterize_filled_triangle({ v1, v3, v2 }, color, emit_pixel);
+void Polyline2D::rasterize_simplified(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    if (simplified_dirty || !same_transform(transform, cached_simplified_transform))
+    {
+        build_simplified_stroke(transform);
+    }
+
+    geometry::rasterize_filled_edges(cached_simplified_edges, FillRule::NON_ZERO, color, emit_pixel);
 }
 
 void Polyline2D::rasterize(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
@@ -134,43 +435,50 @@ void Polyline2D::rasterize(const Matrix3x3d &transform, const std::function<void
         return;
     }
 
-    for (int i = 0; i < points.size() - 1; ++i)
+    if (simplify_tolerance > 0.0)
     {
-        if (segments_visible.size() > i && !segments_visible[i])
-        {
-            continue;
-        }
-        rasterize_edge(points[i], points[i + 1], transform, emit_pixel);
+        rasterize_simplified(transform, emit_pixel);
     }
-
-    if (do_close)
+    else
     {
-        rasterize_edge(points.back(), points.front(), transform, emit_pixel);
+        rasterize_stroke(transform, emit_pixel);
     }
 
-    if (do_rounded_corners)
+    if (do_fill)
     {
-        rasterize_rounded_corners(transform, emit_pixel);
+        rasterize_fill(transform, emit_pixel);
     }
+}
 
-    if (do_fill)
+void Polyline2D::rasterize_fill(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
+{
+    if (fill_dirty)
     {
-        std::vector<Vec2d> transformed_points { utils::transform_points(points, transform) };
+        cache_clockwise();
+        cached_fill = geometry::triangulate_polygon_indexed(Component(get_points(), clockwise));
+        fill_dirty = false;
+    }
 
-        Component polygon { Component(transformed_points, clockwise) };
-        std::vector<Triangle> triangles { geometry::triangulate_polygon(polygon) };
+    std::vector<Vec2d> vertices { utils::transform_points(cached_fill.vertices, transform) };
 
-        for (const auto& triangle : triangles)
-        {
-            geometry::rasterize_filled_triangle(triangle, color, emit_pixel);
-        }
+    if (cached_fill.indices.empty())
+    {
+        std::vector<Edge> edges;
+        append_contour_edges(vertices, edges);
+        geometry::rasterize_filled_edges(edges, FillRule::EVEN_ODD, color, emit_pixel);
+        return;
+    }
+
+    for (const auto &[i0, i1, i2] : cached_fill.indices)
+    {
+        geometry::rasterize_filled_triangle({ vertices[i0], vertices[i1], vertices[i2] }, color, emit_pixel);
     }
 }
 
-bool Polyline2D::cache_clockwise()
+bool Polyline2D::cache_clockwise() const
 {
     double sum = 0.0;
-    for (int i = 0; i < points.size(); ++i)
+    for (std::size_t i = 0; i < points.size(); ++i)
     {
         Vec2d p0 { points[i] };
         Vec2d p1 { points[(i + 1) % points.size()] };
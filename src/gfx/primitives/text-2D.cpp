@@ -1,5 +1,6 @@
 #include <gfx/primitives/text-2D.h>
 #include <gfx/utils/transform.h>
+#include <gfx/geometry/scanline.h>
 #include <gfx/text/utf-8.h>
 
 namespace gfx::primitives
@@ -23,10 +24,12 @@ Box2d Text2D::get_geometry_size() const
         Vec2d(std::numeric_limits<double>::lowest())
     };
 
+    int lod_level { get_lod_level() };
+
     Vec2d pen {0.0, 0.0};
 
     size_t i = 0;
-    uint32_t prev_codepoint = 0;
+    uint16_t prev_glyph_index = 0;
 
     while (i < text.size())
     {
@@ -43,18 +46,20 @@ Box2d Text2D::get_geometry_size() const
         {
             pen.x = 0.0;
             pen.y += line_height;
-            prev_codepoint = 0;
+            prev_glyph_index = 0;
             i += bytes;
             continue;
         }
 
-        if (prev_codepoint != 0)
+        uint16_t glyph_index = font->get_glyph_index(codepoint);
+
+        if (prev_glyph_index != 0)
         {
-            pen.x += font->get_kerning(prev_codepoint, codepoint) * scale;
+            pen.x += font->get_kerning_by_index(prev_glyph_index, glyph_index) * scale;
         }
 
-        auto edges = font->get_glyph_edges(codepoint);
-        for (auto &edge : edges)
+        const auto &edges = font->get_glyph_edges_by_index(glyph_index, lod_level);
+        for (const auto &edge : edges)
         {
             Vec2d v0 = edge.v0 * scale;
             Vec2d v1 = edge.v1 * scale;
@@ -68,99 +73,69 @@ Box2d Text2D::get_geometry_size() const
             bounds.expand(v1);
         }
 
-        pen.x += font->get_glyph_advance(codepoint) * scale;
-        prev_codepoint = codepoint;
+        pen.x += font->get_glyph_advance_by_index(glyph_index) * scale;
+        prev_glyph_index = glyph_index;
         i += bytes;
     }
 
     return Box2d { Vec2d::zero(), bounds.size() };
 }
 
+int Text2D::get_lod_level() const
+{
+    double scale { lod_scale >= 0.0 ? lod_scale : std::max(get_scale().x, get_scale().y) };
+    return font->get_lod_level(font_size * scale);
+}
+
 
-void Text2D::rasterize_glyph(std::vector<ContourEdge> glyph, const std::function<void(const Pixel&)> emit_pixel) const
+void Text2D::rasterize_glyph_sdf(const GlyphSDF &sdf, const Matrix3x3d &glyph_transform, const std::function<void(const Pixel&)> emit_pixel) const
 {
-    if (glyph.empty()) 
+    if (sdf.empty())
     {
         return;
     }
 
-    Box2i bounds { glyph[0].v0.round(), glyph[0].v0.round() };
+    Box2d glyph_bounds { sdf.get_bounds() };
+    Box2d screen_bounds {
+        Vec2d(std::numeric_limits<double>::max()),
+        Vec2d(std::numeric_limits<double>::lowest())
+    };
 
-    for (auto &edge : glyph) 
+    for (const auto &corner : { 
+        glyph_bounds.min, 
+        Vec2d { glyph_bounds.max.x, glyph_bounds.min.y }, 
+        glyph_bounds.max, 
+        Vec2d { glyph_bounds.min.x, glyph_bounds.max.y } })
     {
-        bounds.expand(edge.v0);
-        bounds.expand(edge.v1);
+        screen_bounds.expand(utils::transform_point(corner, glyph_transform));
     }
 
-    const int height = bounds.max.y - bounds.min.y + 1;
+    Matrix3x3d inverse { utils::invert_affine(glyph_transform) };
+    Vec2d step_x { utils::transform_vector({ 1.0, 0.0 }, inverse) };
 
-    std::vector<std::vector<size_t>> edge_table(height);
+    int x0 { static_cast<int>(std::floor(screen_bounds.min.x)) };
+    int x1 { static_cast<int>(std::ceil(screen_bounds.max.x)) };
+    int y0 { static_cast<int>(std::floor(screen_bounds.min.y)) };
+    int y1 { static_cast<int>(std::ceil(screen_bounds.max.y)) };
 
-    for (size_t i = 0; i < glyph.size(); ++i) 
+    for (int y = y0; y <= y1; ++y)
     {
-        const auto &edge = glyph[i];
+        Vec2d point { utils::transform_point(Vec2d { x0 + 0.5, y + 0.5 }, inverse) };
 
-        if (edge.v0.y == edge.v1.y) 
+        for (int x = x0; x <= x1; ++x, point += step_x)
         {
-            continue;
-        }
-
-        int y0 = static_cast<int>(std::floor(std::min(edge.v0.y, edge.v1.y)));
-        int y1 = static_cast<int>(std::ceil(std::max(edge.v0.y, edge.v1.y)));
-
-        for (int y = y0; y < y1; ++y)
-        {
-            if (y >= bounds.min.y && y <= bounds.max.y)
-            {
-                edge_table[y - bounds.min.y].push_back(i);
-            }
-        }
-    }
-
-    for (int y = bounds.min.y; y <= bounds.max.y; ++y)
-    {
-        const auto &row_edges = edge_table[y - bounds.min.y];
-
-        if (row_edges.empty()) 
-        {
-            continue;
-        }
-
-        std::vector<double> intersections;
-        intersections.reserve(row_edges.size());
-
-        for (size_t index : row_edges)
-        {
-            const auto &edge = glyph[index];
-
-            double y0 = edge.v0.y;
-            double y1 = edge.v1.y;
-
-            if ((y < y0 && y < y1) || (y >= y0 && y >= y1)) 
+            // Surfaces do not blend, so a pixel is lit when its center is inside the outline,
+            // matching the scanline path, rather than by partial coverage.
+            if (sdf.sample(point) <= 0.0)
             {
                 continue;
             }
 
-            double t = (y - y0) / (y1 - y0);
-            intersections.push_back(edge.v0.x + t * (edge.v1.x - edge.v0.x));
-        }
-
-        std::sort(intersections.begin(), intersections.end());
-
-        for (size_t i = 0; i + 1 < intersections.size(); i += 2)
-        {
-            int x0 = static_cast<int>(std::ceil(intersections[i]));
-            int x1 = static_cast<int>(std::floor(intersections[i + 1]));
-            for (int x = x0; x <= x1; ++x)
-            {
-                emit_pixel( { { x, y }, color });
-            }
+            emit_pixel({ { x, y }, color });
         }
     }
 }
 
-
-
 void Text2D::rasterize(const Matrix3x3d &transform, const std::function<void(const Pixel&)> emit_pixel) const
 {
     double scale = font_size / font->get_units_per_em();
@@ -176,10 +151,17 @@ void Text2D::rasterize(const Matrix3x3d &transform, const std::function<void(con
     Vec2d min { Vec2d(std::numeric_limits<double>::max()) };
     Vec2d max { Vec2d(std::numeric_limits<double>::lowest()) };
 
+    // One level of detail for the whole draw, so the bounds pass flattens the same
+    // cached outlines the draw pass uses.
+    Vec2d transform_scale { utils::extract_scale(transform) };
+    lod_scale = std::max(transform_scale.x, transform_scale.y);
+    int lod_level { get_lod_level() };
+
     std::vector<double> line_widths { 0.0 };
     int line_index = 0;
 
     size_t i = 0;
+    uint16_t prev_glyph_index = 0;
     while (i < text.size())
     {
         uint32_t codepoint;
@@ -198,20 +180,20 @@ void Text2D::rasterize(const Matrix3x3d &transform, const std::function<void(con
             i += bytes;
             line_index++;
             line_widths.push_back(0.0);
+            prev_glyph_index = 0;
             continue;
         }
 
-        if (i > 0)
+        uint16_t glyph_index = font->get_glyph_index(codepoint);
+
+        if (prev_glyph_index != 0)
         {
-            size_t prev_bytes;
-            uint32_t prev_cp;
-            decode_utf8(text, i - 1, prev_cp, prev_bytes);
-            pen.x += font->get_kerning(prev_cp, codepoint) * scale;
+            pen.x += font->get_kerning_by_index(prev_glyph_index, glyph_index) * scale;
             line_widths[line_index] = pen.x;
         }
 
-        auto edges = font->get_glyph_edges(codepoint);
-        for (auto &edge : edges)
+        const auto &edges = font->get_glyph_edges_by_index(glyph_index, lod_level);
+        for (const auto &edge : edges)
         {
             Vec2d v0 = edge.v0 * scale;
             Vec2d v1 = edge.v1 * scale;
@@ -227,13 +209,17 @@ void Text2D::rasterize(const Matrix3x3d &transform, const std::function<void(con
             max.y = std::max({max.y, v0.y, v1.y});
         }
 
-        pen.x += font->get_glyph_advance(codepoint) * scale;
+        pen.x += font->get_glyph_advance_by_index(glyph_index) * scale;
         line_widths[line_index] = pen.x;
+        prev_glyph_index = glyph_index;
         i += bytes;
     }
 
+    std::vector<ContourEdge> edges;
+
     pen = Vec2d { 0.0, 0.0 };
     line_index = 0;
+    prev_glyph_index = 0;
     i = 0;
     while (i < text.size())
     {
@@ -252,15 +238,15 @@ void Text2D::rasterize(const Matrix3x3d &transform, const std::function<void(con
             pen.y += line_height;
             i += bytes;
             line_index++;
+            prev_glyph_index = 0;
             continue;
         }
 
-        if (i > 0)
+        uint16_t glyph_index = font->get_glyph_index(codepoint);
+
+        if (prev_glyph_index != 0)
         {
-            size_t prev_bytes;
-            uint32_t prev_cp;
-            decode_utf8(text, i - 1, prev_cp, prev_bytes);
-            pen.x += font->get_kerning(prev_cp, codepoint) * scale;
+            pen.x += font->get_kerning_by_index(prev_glyph_index, glyph_index) * scale;
         }
 
         double offset_x { [&] { switch (alignment) 
@@ -272,11 +258,26 @@ void Text2D::rasterize(const Matrix3x3d &transform, const std::function<void(con
             std::unreachable();
         }()};
 
-        auto edges = font->get_glyph_edges(codepoint);
-        for (auto &edge : edges)
+        if (render_mode == RenderMode::SDF)
+        {
+            Matrix3x3d glyph_transform { 
+                transform * 
+                utils::translate({ pen.x - min.x + offset_x, ascent + pen.y - min.y }) * 
+                utils::scale({ scale, -scale }) 
+            };
+
+            rasterize_glyph_sdf(font->get_glyph_sdf_by_index(glyph_index), glyph_transform, emit_pixel);
+            pen.x += font->get_glyph_advance_by_index(glyph_index) * scale;
+            prev_glyph_index = glyph_index;
+            i += bytes;
+            continue;
+        }
+
+        const auto &glyph_edges = font->get_glyph_edges_by_index(glyph_index, lod_level);
+        edges.resize(glyph_edges.size());
+        for (size_t e = 0; e < glyph_edges.size(); ++e)
         {
-            edge.v0 = edge.v0 * scale;
-            edge.v1 = edge.v1 * scale;
+            ContourEdge edge { glyph_edges[e].v0 * scale, glyph_edges[e].v1 * scale };
 
             edge.v0.x += pen.x - min.x + offset_x;
             edge.v1.x += pen.x - min.x + offset_x;
@@ -284,12 +285,13 @@ void Text2D::rasterize(const Matrix3x3d &transform, const std::function<void(con
             edge.v0.y = -edge.v0.y + ascent + pen.y - min.y;
             edge.v1.y = -edge.v1.y + ascent + pen.y - min.y;
 
-            edge.v0 = utils::transform_point(edge.v0, transform);
-            edge.v1 = utils::transform_point(edge.v1, transform);
+            edges[e].v0 = utils::transform_point(edge.v0, transform);
+            edges[e].v1 = utils::transform_point(edge.v1, transform);
         }
 
-        rasterize_glyph(edges, emit_pixel);
-        pen.x += font->get_glyph_advance(codepoint) * scale;
+        geometry::rasterize_filled_edges(edges, geometry::FillRule::NON_ZERO, color, emit_pixel);
+        pen.x += font->get_glyph_advance_by_index(glyph_index) * scale;
+        prev_glyph_index = glyph_index;
         i += bytes;
     }
 }
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cstdio>
 #include <locale.h>
+#include <thread>
 #include <gfx/surfaces/curses/curses-render-surface.h>
 
 namespace gfx::surfaces
@@ -23,90 +26,396 @@ int CursesRenderSurface::init()
     return 0;
 }
 
+void CursesRenderSurface::render_multithreaded()
+{
+    int rows { get_cell_dimensions().y };
+    auto compose = [this](const int start_y, const int end_y) {
+        if (mode == CursesSurfaceMode::TRUECOLOR)
+        {
+            compose_rows<4>(start_y, end_y);
+        }
+        else
+        {
+            compose_rows<2>(start_y, end_y);
+        }
+    };
 
-void CursesRenderSurface::present()
+    unsigned int num_threads { std::max(1u, std::thread::hardware_concurrency()) };
+    if (num_threads == 1 || get_cell_dimensions().x * rows < MIN_MULTITHREAD_CELLS)
+    {
+        compose(0, rows);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; ++i)
+    {
+        int start_y { static_cast<int>(i * rows / num_threads) };
+        int end_y { static_cast<int>((i + 1) * rows / num_threads) };
+        threads.emplace_back(compose, start_y, end_y);
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+template <int CellHeight>
+void CursesRenderSurface::compose_rows(const int start_y, const int end_y)
 {
-    Vec2i frame_buffer_dimensions { resolution / 2 };
-    for (int y = 0; y < frame_buffer_dimensions.y; y++)
+    static constexpr int CELL_PIXELS { 2 * CellHeight };
+
+    // Dot bits for the pixels of a cell, left then right on each row. Two rows index
+    // pixel_tree; four rows are the Unicode braille dots 1-8.
+    static constexpr int64_t palette_dots[4] { 0b1000, 0b0100, 0b0010, 0b0001 };
+    static constexpr int64_t braille_dots[8] { 0x01, 0x08, 0x02, 0x10, 0x04, 0x20, 0x40, 0x80 };
+    const int64_t* dot_bits { CellHeight == 2 ? palette_dots : braille_dots };
+    static constexpr int64_t all_dots { CellHeight == 2 ? 0b1111 : 0xFF };
+
+    int cells_x { resolution.x / 2 };
+
+    for (int y = start_y; y < end_y; y++)
     {
-        for (int x = 0; x < frame_buffer_dimensions.x; x++)
+        const Color4* rows[CellHeight];
+        for (int row = 0; row < CellHeight; row++)
+        {
+            rows[row] = &pixels[static_cast<std::size_t>(CellHeight * y + row) * resolution.x];
+        }
+        int64_t* cells { &(*frame_buffer)[static_cast<std::size_t>(y) * cells_x] };
+
+        for (int x = 0; x < cells_x; x++)
         {
-            int frame_buffer_index { y * resolution.x + x };
-            if (frame_buffer_index < 0 || frame_buffer_index >= frame_buffer->size())
+            Color4 block[CELL_PIXELS];
+            bool uniform { true };
+            for (int i = 0; i < CELL_PIXELS; i++)
             {
-                continue;
+                block[i] = rows[i / 2][2 * x + (i & 1)];
+                uniform = uniform && block[i] == block[0];
             }
-            int64_t pixel_value { frame_buffer->at(frame_buffer_index) };
-            if ((pixel_value & 0x00000000000000FF) == 0)
+
+            // Most blocks are empty or a single color.
+            if (uniform)
             {
+                cells[x] = block[0].a == 0 ? 0 : (static_cast<int64_t>(block[0].to_i32()) << 32) | all_dots;
                 continue;
             }
 
-            std::string_view pixel {
-                pixel_tree[(pixel_value & 0b1000) >> 3]
-                [(pixel_value & 0b0100) >> 2]
-                [(pixel_value & 0b0010) >> 1]
-                [(pixel_value & 0b0001)] 
-            };
+            int32_t colors[CELL_PIXELS];
+            int num_lit { 0 };
+            int64_t dots { 0 };
+
+            for (int i = 0; i < CELL_PIXELS; i++)
+            {
+                if (block[i].a != 0)
+                {
+                    dots |= dot_bits[i];
+                    colors[num_lit++] = block[i].to_i32();
+                }
+            }
 
-            Color4 color { Color4::from_i32(pixel_value >> 32) };
-            if (color.a == 0)
+            // Ties go to the pixel nearest the top left.
+            int32_t color { 0 };
+            int most_votes { 0 };
+            for (int i = 0; i < num_lit; i++)
+            {
+                int votes { static_cast<int>(std::count(colors, colors + num_lit, colors[i])) };
+                if (votes > most_votes)
+                {
+                    most_votes = votes;
+                    color = colors[i];
+                }
+            }
+
+            cells[x] = num_lit == 0 ? 0 : (static_cast<int64_t>(color) << 32) | dots;
+        }
+    }
+}
+
+void CursesRenderSurface::compose_text()
+{
+    Vec2i cell_dimensions { get_cell_dimensions() };
+
+    for (const TextOverlay &overlay : text_overlays)
+    {
+        if (overlay.cell.y < 0 || overlay.cell.y >= cell_dimensions.y)
+        {
+            continue;
+        }
+
+        int64_t color { static_cast<int64_t>(overlay.color.to_i32()) << 32 };
+        for (std::size_t i = 0; i < overlay.text.size(); i++)
+        {
+            int x { overlay.cell.x + static_cast<int>(i) };
+            if (x < 0 || x >= cell_dimensions.x)
             {
                 continue;
             }
-            set_color(color);
-            mvaddstr(y, x, pixel.data());
+            int64_t character { static_cast<uint8_t>(overlay.text[i]) };
+            (*frame_buffer)[overlay.cell.y * cell_dimensions.x + x] = color | TEXT_CELL | (character << 8);
         }
     }
+    text_overlays.clear();
 }
 
-void CursesRenderSurface::clear() const
+void CursesRenderSurface::draw_text(const Vec2i cell, const std::string_view text, const Color4 color)
 {
-    erase();
+    text_overlays.push_back({ cell, std::string { text }, color });
 }
 
-void CursesRenderSurface::clear_frame_buffer()
+int64_t CursesRenderSurface::visible_cell(const int64_t cell)
 {
-    for (int64_t &pixel : *frame_buffer)
+    bool empty { (cell & 0x00000000FFFFFFFF) == 0 };
+    bool transparent { ((cell >> 32) & 0xFF) == 0 };
+    return empty || transparent ? 0 : cell;
+}
+
+void CursesRenderSurface::append_glyph(std::string &text, const int64_t cell) const
+{
+    if (cell == 0)
+    {
+        text.push_back(' ');
+    }
+    else if (cell & TEXT_CELL)
+    {
+        text.push_back(static_cast<char>((cell >> 8) & 0xFF));
+    }
+    else if (mode == CursesSurfaceMode::TRUECOLOR)
+    {
+        // U+2800 plus the dot bits, in UTF-8.
+        text.push_back(static_cast<char>(0xE2));
+        text.push_back(static_cast<char>(0xA0 | ((cell >> 6) & 0x03)));
+        text.push_back(static_cast<char>(0x80 | (cell & 0x3F)));
+    }
+    else
     {
-        pixel = 0;
+        text.append(pixel_tree[(cell & 0b1000) >> 3][(cell & 0b0100) >> 2][(cell & 0b0010) >> 1][cell & 0b0001]);
     }
 }
 
-void CursesRenderSurface::write_pixel(const gfx::math::Vec2i pos, const gfx::core::types::Color4 color, const int depth)
+void CursesRenderSurface::present()
+{
+    render_multithreaded();
+    compose_text();
+
+    if (mode == CursesSurfaceMode::TRUECOLOR)
+    {
+        present_truecolor();
+    }
+    else
+    {
+        present_palette();
+    }
+}
+
+void CursesRenderSurface::present_palette()
 {
-    bool left_in_pixel { pos.x % 2 == 0 };
-    bool top_in_pixel { pos.y % 2 == 0 };
-    int frame_buffer_index { (pos.y / 2) * resolution.x + pos.x / 2 };
+    if (needs_erase)
+    {
+        erase();
+        needs_erase = false;
+    }
+
+    Vec2i frame_buffer_dimensions { get_cell_dimensions() };
 
-    if (frame_buffer_index < 0 || frame_buffer_index >= frame_buffer->size())
+    for (int y = 0; y < frame_buffer_dimensions.y; y++)
+    {
+        int x { 0 };
+        while (x < frame_buffer_dimensions.x)
+        {
+            int frame_buffer_index { y * frame_buffer_dimensions.x + x };
+            if (visible_cell((*frame_buffer)[frame_buffer_index]) == presented_cells[frame_buffer_index])
+            {
+                x++;
+                continue;
+            }
+
+            // Gather changed cells until one is unchanged or needs another color. Blank cells
+            // print as spaces and fit any color.
+            int run_start { x };
+            int64_t run_color { 0 };
+            run_text.clear();
+
+            for (; x < frame_buffer_dimensions.x; x++, frame_buffer_index++)
+            {
+                int64_t cell { visible_cell((*frame_buffer)[frame_buffer_index]) };
+                if (cell == presented_cells[frame_buffer_index])
+                {
+                    break;
+                }
+
+                if (cell != 0)
+                {
+                    int64_t cell_color { cell >> 32 };
+                    if (run_color != 0 && cell_color != run_color)
+                    {
+                        break;
+                    }
+                    run_color = cell_color;
+                }
+
+                append_glyph(run_text, cell);
+                presented_cells[frame_buffer_index] = cell;
+            }
+
+            if (run_color != 0)
+            {
+                set_color(Color4::from_i32(static_cast<int32_t>(run_color)));
+            }
+            mvaddstr(y, run_start, run_text.c_str());
+        }
+    }
+
+    if (evicted_colors.empty())
     {
         return;
     }
 
-    int64_t color_mask { static_cast<int64_t>(color.to_i32()) << 32 };
-    frame_buffer->at(frame_buffer_index) &= 0x00000000000000FF;
-    frame_buffer->at(frame_buffer_index) |= color_mask;
+    // Cells drawn in an evicted color now show whatever its color number was redefined to,
+    // including cells written earlier in this present.
+    std::sort(evicted_colors.begin(), evicted_colors.end());
+    for (auto &cell : presented_cells)
+    {
+        if (cell != INVALID_CELL && cell != 0 && std::binary_search(evicted_colors.begin(), evicted_colors.end(), cell >> 32))
+        {
+            cell = INVALID_CELL;
+        }
+    }
+    evicted_colors.clear();
+}
+
+void CursesRenderSurface::present_truecolor()
+{
+    output_buffer.clear();
+
+    if (needs_erase)
+    {
+        // Let curses settle the screen first so that its next refresh leaves these cells alone.
+        erase();
+        refresh();
+        output_buffer.append("\x1b[2J");
+        needs_erase = false;
+    }
+
+    Vec2i frame_buffer_dimensions { get_cell_dimensions() };
+    int64_t current_color { 0 };
+    char escape[32];
 
-    static constexpr int8_t bit_masks[2][2] {
-        { 0b0001, 0b0010 },
-        { 0b0100, 0b1000 }
-    };
+    for (int y = 0; y < frame_buffer_dimensions.y; y++)
+    {
+        // Column the terminal cursor is at on this row, or -1 when it has to be moved.
+        int cursor_x { -1 };
+
+        for (int x = 0; x < frame_buffer_dimensions.x; x++)
+        {
+            int frame_buffer_index { y * frame_buffer_dimensions.x + x };
+            int64_t cell { visible_cell((*frame_buffer)[frame_buffer_index]) };
+            if (cell == presented_cells[frame_buffer_index])
+            {
+                continue;
+            }
+
+            if (cursor_x != x)
+            {
+                int length { std::snprintf(escape, sizeof(escape), "\x1b[%d;%dH", y + 1, x + 1) };
+                output_buffer.append(escape, length);
+            }
+
+            int64_t cell_color { cell >> 32 };
+            if (cell != 0 && cell_color != current_color)
+            {
+                Color4 color { Color4::from_i32(static_cast<int32_t>(cell_color)) };
+                int length { std::snprintf(escape, sizeof(escape), "\x1b[38;2;%d;%d;%dm", color.r, color.g, color.b) };
+                output_buffer.append(escape, length);
+                current_color = cell_color;
+            }
+
+            append_glyph(output_buffer, cell);
+            presented_cells[frame_buffer_index] = cell;
+            cursor_x = x + 1;
+        }
+    }
+
+    if (output_buffer.empty())
+    {
+        return;
+    }
+
+    output_buffer.append("\x1b[0m");
+    std::fwrite(output_buffer.data(), 1, output_buffer.size(), stdout);
+    std::fflush(stdout);
+}
+
+// The screen is patched in place by present(), so there is nothing to wipe between frames.
+void CursesRenderSurface::clear() const
+{
+}
+
+void CursesRenderSurface::clear_frame_buffer()
+{
+    std::fill(pixels.begin(), pixels.end(), Color4 { 0, 0, 0, 0 });
+}
 
-    frame_buffer->at(frame_buffer_index) |= 
-        bit_masks[top_in_pixel][left_in_pixel];
+void CursesRenderSurface::write_pixel(const gfx::math::Vec2i pos, const gfx::core::types::Color4 color, const int depth)
+{
+    if (pos.x < 0 || pos.y < 0 || pos.x >= resolution.x || pos.y >= resolution.y)
+    {
+        return;
+    }
+    pixels[static_cast<std::size_t>(pos.y) * resolution.x + pos.x] = color;
 }
 
 void CursesRenderSurface::resize(const gfx::math::Vec2i new_resolution)
 {
     resolution = new_resolution;
-    frame_buffer->resize((resolution.x * resolution.y / 2), 0);
+    Vec2i cell_dimensions { get_cell_dimensions() };
+    frame_buffer->assign(static_cast<std::size_t>(cell_dimensions.x) * cell_dimensions.y, 0);
+    pixels.assign(static_cast<std::size_t>(resolution.x) * resolution.y, Color4 { 0, 0, 0, 0 });
+
+    // Cells map to different screen positions at the new width.
+    presented_cells.assign(frame_buffer->size(), INVALID_CELL);
+    needs_erase = true;
 }
 
 void CursesRenderSurface::clear_palette()
 {
     palette->clear();
+    slot_colors.clear();
+    evicted_colors.clear();
     color_index = 0;
+    invalidate();
+}
+
+void CursesRenderSurface::invalidate()
+{
+    std::fill(presented_cells.begin(), presented_cells.end(), INVALID_CELL);
+}
+
+void CursesRenderSurface::invalidate(const Box2i cells)
+{
+    Vec2i cell_dimensions { get_cell_dimensions() };
+    int min_x { std::max(cells.min.x, 0) };
+    int max_x { std::min(cells.max.x, cell_dimensions.x) };
+    int min_y { std::max(cells.min.y, 0) };
+    int max_y { std::min(cells.max.y, cell_dimensions.y) };
+
+    for (int y = min_y; y < max_y; y++)
+    {
+        for (int x = min_x; x < max_x; x++)
+        {
+            presented_cells[y * cell_dimensions.x + x] = INVALID_CELL;
+        }
+    }
+}
+
+void CursesRenderSurface::invalidate_text(const Vec2i cell, const std::vector<std::string> &lines)
+{
+    std::size_t width { 0 };
+    for (const auto &line : lines)
+    {
+        width = std::max(width, line.size());
+    }
+    invalidate({ cell, cell + Vec2i { static_cast<int>(width), static_cast<int>(lines.size()) } });
 }
 
 void CursesRenderSurface::set_color(const Color4 color)
@@ -131,6 +440,21 @@ uint8_t CursesRenderSurface::add_color(const Color4 color)
     {
         color_index = 0;
     }
+
+    // Once every color number is taken they are reused in order. The old color loses its
+    // entry so it gets a number of its own when it is next drawn.
+    if (static_cast<std::size_t>(color_index) < slot_colors.size())
+    {
+        Color4 &slot_color { slot_colors[color_index] };
+        palette->erase(slot_color);
+        evicted_colors.push_back(slot_color.to_i32());
+        slot_color = color;
+    }
+    else
+    {
+        slot_colors.push_back(color);
+    }
+
     uint8_t index { static_cast<uint8_t>(color_index + DEDICATED_CURSES_COLOR_START_INDEX) };
     palette->emplace(color, index);
     color_index += 1;
@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <gfx/text/font-bundle.h>
+
+namespace gfx::text
+{
+
+static_assert(sizeof(ContourEdge) == 4 * sizeof(double));
+static_assert(sizeof(GlyphEdgeRange) == 2 * sizeof(uint32_t));
+static_assert(sizeof(GlyphMetrics) == 2 * sizeof(int));
+
+struct FontBundleHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t source_checksum;
+    uint64_t file_size;
+
+    double ascent;
+    double descent;
+    double line_gap;
+    int32_t units_per_em;
+    int32_t num_glyphs;
+
+    uint32_t num_pages;
+    uint32_t num_kerning_pairs;
+    uint32_t num_class_tables;
+    uint32_t first_lod_level;
+    uint32_t num_lod_levels;
+    uint32_t num_edges;
+
+    uint64_t page_index_offset;
+    uint64_t pages_offset;
+    uint64_t metrics_offset;
+    uint64_t kerning_pairs_offset;
+    uint64_t class_tables_offset;
+    uint64_t edge_ranges_offset;
+    uint64_t edges_offset;
+};
+
+struct ClassTableHeader
+{
+    uint32_t num_left_classes;
+    uint32_t num_right_classes;
+    uint32_t num_values;
+    uint16_t num_left_class_ids;
+    uint16_t num_right_class_ids;
+};
+
+static uint64_t append_bytes(std::vector<uint8_t> &buffer, const void* data, const std::size_t size)
+{
+    buffer.resize((buffer.size() + 7) & ~static_cast<std::size_t>(7), 0);
+    uint64_t offset { buffer.size() };
+    if (size > 0)
+    {
+        buffer.insert(buffer.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    }
+    return offset;
+}
+
+template <typename T>
+static uint64_t append_array(std::vector<uint8_t> &buffer, const std::vector<T> &values)
+{
+    return append_bytes(buffer, values.data(), values.size() * sizeof(T));
+}
+
+uint64_t compute_font_checksum(const uint8_t* data, const std::size_t size)
+{
+    uint64_t hash { 0xcbf29ce484222325ull };
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash ^ size;
+}
+
+void write_font_bundle(const FontTTF &font, const uint64_t source_checksum, const std::filesystem::path &path)
+{
+    const CodepointMap &codepoint_map { font.get_codepoint_map() };
+    const KerningTable &kerning { font.get_kerning_table() };
+
+    FontBundleHeader header {};
+    header.magic = FONT_BUNDLE_MAGIC;
+    header.version = FONT_BUNDLE_VERSION;
+    header.source_checksum = source_checksum;
+    header.ascent = font.get_ascent();
+    header.descent = font.get_descent();
+    header.line_gap = font.get_line_gap();
+    header.units_per_em = static_cast<int32_t>(font.get_units_per_em());
+    header.num_glyphs = font.get_num_glyphs();
+    header.num_pages = static_cast<uint32_t>(codepoint_map.get_pages().size());
+    header.num_kerning_pairs = static_cast<uint32_t>(kerning.num_pairs());
+    header.num_class_tables = static_cast<uint32_t>(kerning.num_class_tables());
+    header.first_lod_level = FontTTF::DEFAULT_LOD_LEVEL;
+    header.num_lod_levels = FontTTF::NUM_LOD_LEVELS - FontTTF::DEFAULT_LOD_LEVEL;
+
+    std::vector<uint8_t> buffer(sizeof(FontBundleHeader), 0);
+
+    header.page_index_offset = append_array(buffer, codepoint_map.get_page_index());
+    header.pages_offset = append_array(buffer, codepoint_map.get_pages());
+
+    std::vector<GlyphMetrics> metrics { font.get_metrics() };
+    metrics.resize(header.num_glyphs, GlyphMetrics { 0, 0 });
+    header.metrics_offset = append_array(buffer, metrics);
+
+    header.kerning_pairs_offset = append_array(buffer, kerning.get_pairs());
+
+    header.class_tables_offset = append_bytes(buffer, nullptr, 0);
+    for (const auto &table : kerning.get_class_tables())
+    {
+        ClassTableHeader table_header {
+            static_cast<uint32_t>(table.left_classes.size()),
+            static_cast<uint32_t>(table.right_classes.size()),
+            static_cast<uint32_t>(table.values.size()),
+            static_cast<uint16_t>(table.num_right_classes > 0 ? table.values.size() / table.num_right_classes : 0),
+            table.num_right_classes
+        };
+        append_bytes(buffer, &table_header, sizeof(table_header));
+        append_array(buffer, table.left_classes);
+        append_array(buffer, table.right_classes);
+        append_array(buffer, table.values);
+    }
+
+    std::vector<GlyphEdgeRange> ranges;
+    std::vector<ContourEdge> edges;
+    ranges.reserve(static_cast<std::size_t>(header.num_lod_levels) * header.num_glyphs);
+
+    for (uint32_t level = 0; level < header.num_lod_levels; ++level)
+    {
+        for (int glyph_index = 0; glyph_index < header.num_glyphs; ++glyph_index)
+        {
+            auto glyph_edges { font.get_glyph_edges_by_index(static_cast<uint16_t>(glyph_index), header.first_lod_level + level) };
+            ranges.push_back({ static_cast<uint32_t>(edges.size()), static_cast<uint32_t>(glyph_edges.size()) });
+            edges.insert(edges.end(), glyph_edges.begin(), glyph_edges.end());
+        }
+    }
+
+    header.num_edges = static_cast<uint32_t>(edges.size());
+    header.edge_ranges_offset = append_array(buffer, ranges);
+    header.edges_offset = append_array(buffer, edges);
+    header.file_size = buffer.size();
+
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    std::filesystem::create_directories(path.parent_path());
+
+    // Write next to the target and rename so a concurrent reader never maps a partial file.
+    // Each writer gets its own temp file, so processes or threads racing on the same bundle
+    // never interleave their writes.
+    static std::atomic<uint32_t> temp_counter { 0 };
+    std::filesystem::path temp_path { path };
+    temp_path += "." + std::to_string(getpid()) + "." + std::to_string(temp_counter++) + ".tmp";
+
+    {
+        std::ofstream out { temp_path, std::ios::binary | std::ios::trunc };
+        if (!out)
+        {
+            throw std::runtime_error("Failed to open font bundle for writing: " + temp_path.string());
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!out)
+        {
+            throw std::runtime_error("Failed to write font bundle: " + temp_path.string());
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+        throw std::runtime_error("Failed to move font bundle into place: " + path.string());
+    }
+}
+
+std::shared_ptr<FontTTF> load_font_bundle(const std::filesystem::path &path, const uint64_t source_checksum)
+{
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+    {
+        return nullptr;
+    }
+
+    auto file { std::make_shared<utils::MappedFile>(path) };
+    if (file->size() < sizeof(FontBundleHeader))
+    {
+        return nullptr;
+    }
+
+    const uint8_t* data { file->data() };
+
+    FontBundleHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != FONT_BUNDLE_MAGIC || 
+        header.version != FONT_BUNDLE_VERSION || 
+        header.source_checksum != source_checksum || 
+        header.file_size != file->size())
+    {
+        return nullptr;
+    }
+
+    auto fits { [&](const uint64_t offset, const uint64_t size) {
+        return offset % 8 == 0 && offset <= header.file_size && size <= header.file_size - offset;
+    } };
+
+    uint64_t num_glyphs { static_cast<uint64_t>(std::max(header.num_glyphs, 0)) };
+    uint64_t num_ranges { num_glyphs * header.num_lod_levels };
+
+    if (header.num_pages == 0 || 
+        header.first_lod_level + header.num_lod_levels > FontTTF::NUM_LOD_LEVELS ||
+        !fits(header.page_index_offset, CodepointMap::NUM_PAGES * sizeof(uint16_t)) ||
+        !fits(header.pages_offset, header.num_pages * sizeof(CodepointMap::Page)) ||
+        !fits(header.metrics_offset, num_glyphs * sizeof(GlyphMetrics)) ||
+        !fits(header.kerning_pairs_offset, header.num_kerning_pairs * sizeof(KerningPair)) ||
+        !fits(header.edge_ranges_offset, num_ranges * sizeof(GlyphEdgeRange)) ||
+        !fits(header.edges_offset, header.num_edges * sizeof(ContourEdge)))
+    {
+        return nullptr;
+    }
+
+    std::vector<uint16_t> page_index(CodepointMap::NUM_PAGES);
+    std::memcpy(page_index.data(), data + header.page_index_offset, page_index.size() * sizeof(uint16_t));
+    if (std::any_of(page_index.begin(), page_index.end(), [&](const uint16_t page) { return page >= header.num_pages; }))
+    {
+        return nullptr;
+    }
+
+    std::vector<CodepointMap::Page> pages(header.num_pages);
+    std::memcpy(pages.data(), data + header.pages_offset, pages.size() * sizeof(CodepointMap::Page));
+
+    std::vector<GlyphMetrics> metrics(num_glyphs);
+    std::memcpy(metrics.data(), data + header.metrics_offset, metrics.size() * sizeof(GlyphMetrics));
+
+    std::vector<KerningPair> pairs(header.num_kerning_pairs);
+    std::memcpy(pairs.data(), data + header.kerning_pairs_offset, pairs.size() * sizeof(KerningPair));
+
+    std::vector<KerningClassTable> class_tables(header.num_class_tables);
+    uint64_t offset { header.class_tables_offset };
+    for (auto &table : class_tables)
+    {
+        ClassTableHeader table_header;
+        if (!fits(offset, sizeof(table_header)))
+        {
+            return nullptr;
+        }
+        std::memcpy(&table_header, data + offset, sizeof(table_header));
+        offset += sizeof(table_header);
+
+        auto read_array { [&](auto &values, const uint32_t count) {
+            offset = (offset + 7) & ~static_cast<uint64_t>(7);
+            uint64_t size { static_cast<uint64_t>(count) * sizeof(values[0]) };
+            if (!fits(offset, size))
+            {
+                return false;
+            }
+            values.resize(count);
+            std::memcpy(values.data(), data + offset, size);
+            offset += size;
+            return true;
+        } };
+
+        if (!read_array(table.left_classes, table_header.num_left_classes) ||
+            !read_array(table.right_classes, table_header.num_right_classes) ||
+            !read_array(table.values, table_header.num_values))
+        {
+            return nullptr;
+        }
+
+        // get() indexes values by the stored class ids unchecked, so a table that does not
+        // match its own dimensions is treated as a stale bundle.
+        uint16_t num_left_class_ids { table_header.num_left_class_ids };
+        uint16_t num_right_class_ids { table_header.num_right_class_ids };
+        if (table.values.size() != static_cast<std::size_t>(num_left_class_ids) * num_right_class_ids ||
+            std::any_of(table.left_classes.begin(), table.left_classes.end(), [&](const uint16_t left_class) {
+                return left_class != KerningClassTable::NOT_COVERED && left_class >= num_left_class_ids;
+            }) ||
+            std::any_of(table.right_classes.begin(), table.right_classes.end(), [&](const uint16_t right_class) {
+                return right_class >= num_right_class_ids;
+            }))
+        {
+            return nullptr;
+        }
+
+        table.num_right_classes = num_right_class_ids;
+        offset = (offset + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    std::span<const GlyphEdgeRange> ranges { reinterpret_cast<const GlyphEdgeRange*>(data + header.edge_ranges_offset), num_ranges };
+    std::span<const ContourEdge> edges { reinterpret_cast<const ContourEdge*>(data + header.edges_offset), header.num_edges };
+
+    for (const auto &range : ranges)
+    {
+        if (range.offset > edges.size() || range.count > edges.size() - range.offset)
+        {
+            return nullptr;
+        }
+    }
+
+    auto font { std::make_shared<FontTTF>(
+        header.units_per_em,
+        header.ascent,
+        header.descent,
+        header.line_gap,
+        header.num_glyphs
+    ) };
+
+    font->set_codepoint_map(CodepointMap { std::move(page_index), std::move(pages) });
+    font->set_metrics(metrics);
+    font->set_kerning_table(KerningTable { std::move(pairs), std::move(class_tables) });
+
+    for (uint32_t level = 0; level < header.num_lod_levels; ++level)
+    {
+        font->set_mapped_edges(header.first_lod_level + level, ranges.subspan(level * num_glyphs, num_glyphs), edges);
+    }
+    font->set_mapped_storage(file);
+
+    return font;
+}
+
+}
@@ -1,8 +1,13 @@
 #include <map>
-#include <fstream>
+#include <bit>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <gfx/text/font-manager-ttf.h>
 #include <gfx/text/font-ttf.h>
+#include <gfx/text/font-bundle.h>
 #include <gfx/math/vec2.h>
+#include <gfx/utils/mapped-file.h>
 
 namespace gfx::text
 {
@@ -35,8 +40,10 @@ static uint32_t read_u32(const std::uint8_t* data)
            static_cast<uint32_t>(data[3]);
 }
 
-void FontManagerTTF::load_font_directory(const std::filesystem::path &path)
+FontDirectoryReport FontManagerTTF::load_font_directory(const std::filesystem::path &path)
 {
+    auto t0 { std::chrono::steady_clock::now() };
+
     std::filesystem::path dir_path = path;
 
     if (dir_path.empty())
@@ -47,9 +54,10 @@ void FontManagerTTF::load_font_directory(const std::filesystem::path &path)
     if (!std::filesystem::exists(dir_path) || !std::filesystem::is_directory(dir_path))
     {
         throw std::runtime_error("Font directory does not exist: " + dir_path.string());
-        return;
     }
 
+    FontDirectoryReport report;
+
     for (const auto& entry : std::filesystem::directory_iterator(dir_path))
     {
         if (entry.is_regular_file())
@@ -57,45 +65,137 @@ void FontManagerTTF::load_font_directory(const std::filesystem::path &path)
             std::string extension { entry.path().extension().string() };
             if (extension == ".ttf" || extension == ".TTF")
             {
-                try
-                {
-                    load_from_file(entry.path().string(), entry.path().stem().string());
-                }
-                catch (const std::exception &e)
-                {
-                }
+                FontLoadReport font_report;
+                font_report.name = entry.path().stem().string();
+                font_report.path = entry.path();
+                report.fonts.push_back(font_report);
             }
         }
     }
+
+    std::vector<std::shared_ptr<FontTTF>> fonts(report.fonts.size());
+    std::atomic<std::size_t> next_index { 0 };
+
+    auto worker = [&]() {
+        for (std::size_t i = next_index++; i < report.fonts.size(); i = next_index++)
+        {
+            FontLoadReport &font_report { report.fonts[i] };
+            auto font_t0 { std::chrono::steady_clock::now() };
+            try
+            {
+                fonts[i] = parse_font_file(font_report.path, font_report.name, font_report);
+            }
+            catch (const std::exception &e)
+            {
+                font_report.error = e.what();
+            }
+            font_report.load_time_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - font_t0
+            ).count();
+        }
+    };
+
+    unsigned int hw { std::thread::hardware_concurrency() };
+    unsigned int num_threads { static_cast<unsigned int>(std::min<std::size_t>(hw ? hw : 2, report.fonts.size())) };
+    report.num_threads = std::max(num_threads, 1u);
+
+    if (num_threads > 1)
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (unsigned int i = 0; i < num_threads; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+    else
+    {
+        worker();
+    }
+
+    for (std::size_t i = 0; i < fonts.size(); ++i)
+    {
+        if (fonts[i])
+        {
+            loaded_fonts[report.fonts[i].name] = fonts[i];
+        }
+    }
+
+    report.total_time_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t0
+    ).count();
+
+    return report;
 }
 
 std::shared_ptr<FontTTF> FontManagerTTF::load_from_file(const std::string &path, const std::string &name)
 {
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file.is_open())
+    FontLoadReport report;
+    std::string font_name { name.empty() ? path : name };
+
+    auto font { parse_font_file(path, font_name, report) };
+    loaded_fonts[font_name] = font;
+
+    return font;
+}
+
+std::shared_ptr<FontTTF> FontManagerTTF::parse_font_file(const std::filesystem::path &path, const std::string &name, FontLoadReport &report)
+{
+    utils::MappedFile file { path };
+    if (file.empty())
     {
-        throw std::runtime_error("Failed to open file: " + path);
-        return nullptr;
+        throw std::runtime_error("File is empty: " + path.string());
     }
 
-    std::streamsize size { file.tellg() };
-    if (size <= 0)
+    report.bytes_mapped = file.size();
+
+    if (bundle_directory_path.empty())
     {
-        throw std::runtime_error("File is empty: " + path);
-        return nullptr;
+        auto font { parse_font(file.data(), file.size(), name) };
+        report.num_glyphs = font->get_num_glyphs();
+        return font;
     }
-    file.seekg(0, std::ios::beg);
-    uint8_t* buffer { new uint8_t[size] };
-    if (!file.read(reinterpret_cast<char*>(buffer), size))
+
+    uint64_t checksum { compute_font_checksum(file.data(), file.size()) };
+    std::filesystem::path bundle_path { bundle_directory_path / (path.filename().string() + ".gfxfont") };
+
+    auto font { load_font_bundle(bundle_path, checksum) };
+    if (font)
     {
-        throw std::runtime_error("Failed to read file: " + path);
-        return nullptr;
+        font->set_name(name);
+        report.from_bundle = true;
+        report.num_glyphs = font->get_num_glyphs();
+        return font;
     }
 
-    return load_from_memory(buffer, size, name.empty() ? path : name);
+    font = parse_font(file.data(), file.size(), name);
+    report.num_glyphs = font->get_num_glyphs();
+
+    // A failed write only costs the next start another parse.
+    try
+    {
+        write_font_bundle(*font, checksum, bundle_path);
+    }
+    catch (const std::exception &)
+    {
+    }
+
+    return font;
 }
 
 std::shared_ptr<FontTTF> FontManagerTTF::load_from_memory(const uint8_t* data, const std::size_t size, const std::string &name)
+{
+    auto font { parse_font(data, size, name) };
+    loaded_fonts[name] = font;
+
+    return font;
+}
+
+std::shared_ptr<FontTTF> FontManagerTTF::parse_font(const uint8_t* data, const std::size_t size, const std::string &name)
 {
     if (size < 12)
     {
@@ -200,25 +300,36 @@ std::shared_ptr<FontTTF> FontManagerTTF::load_from_memory(const uint8_t* data, c
         const std::uint8_t* subtable { cmap_table + offset };
         uint16_t format { read_u16(subtable) };
 
-        if (format == 4 && !cmap_format_4 && platform_id == 3 && encoding_id == 1)
+        bool unicode_bmp { (platform_id == 3 && encoding_id == 1) || platform_id == 0 };
+        bool unicode_full { (platform_id == 3 && encoding_id == 10) || platform_id == 0 };
+
+        if (format == 4 && !cmap_format_4 && unicode_bmp)
         {
             cmap_format_4 = subtable;
         }
-        else if (format == 12 && !cmap_format_12 && platform_id == 3 && encoding_id == 10)
+        else if (format == 12 && !cmap_format_12 && unicode_full)
         {
             cmap_format_12 = subtable;
         }
     }
 
-    if (!cmap_format_4)
+    if (!cmap_format_4 && !cmap_format_12)
     {
-        throw std::runtime_error("No supported cmap subtable found (format 4).");
+        throw std::runtime_error("No supported cmap subtable found (format 4 or 12).");
         return nullptr;
     }
 
-    std::unordered_map<uint32_t, uint16_t> codepoint_to_index { 
-        parse_cmap_format_4(cmap_format_4, it_cmap->second.length) 
-    };
+    const std::uint8_t* cmap_end { cmap_table + it_cmap->second.length };
+
+    CodepointMap codepoint_map;
+    if (cmap_format_12)
+    {
+        parse_cmap_format_12(cmap_format_12, cmap_end, codepoint_map);
+    }
+    else
+    {
+        parse_cmap_format_4(cmap_format_4, cmap_end, codepoint_map);
+    }
 
     auto it_glyf { tables.find("glyf") };
     if (it_glyf == tables.end())
@@ -270,58 +381,28 @@ std::shared_ptr<FontTTF> FontManagerTTF::load_from_memory(const uint8_t* data, c
         glyphs.push_back(parse_glyph(glyf_table, glyph_offsets, i, index_to_loc_format == 1));
     }
 
-    std::unordered_map<uint32_t, std::shared_ptr<GlyphTTF>> codepoint_to_glyph;
-    for (const auto& [codepoint, glyph_index] : codepoint_to_index)
-    {
-        if (glyph_index < glyphs.size())
-        {
-            codepoint_to_glyph[codepoint] = glyphs[glyph_index];
-        }
-    }
-    font->set_glyphs(codepoint_to_glyph);
+    font->set_glyphs(glyphs);
+    font->set_codepoint_map(std::move(codepoint_map));
+
+    KerningTable kerning;
 
     auto it_kern { tables.find("kern") };
     if (it_kern != tables.end())
     {
         const uint8_t* kern_table { data + it_kern->second.offset };
-        std::size_t kern_length { it_kern->second.length };
-
-        if (kern_length >= 4)
-        {
-            uint16_t num_subtables { read_u16(kern_table + 2) };
-            const uint8_t* subtable_ptr { kern_table + 4 };
-
-            for (uint16_t i = 0; i < num_subtables; ++i)
-            {
-                if (subtable_ptr + 6 > kern_table + kern_length)
-                {
-                    break;
-                }
-
-                uint16_t st_version { read_u16(subtable_ptr) };
-                uint16_t st_length  { read_u16(subtable_ptr + 2) };
-                uint16_t st_format  { read_u16(subtable_ptr + 4) };
-
-                if (st_format == 0)
-                {
-                    const uint8_t* data_ptr { subtable_ptr + 6 };
-                    std::size_t num_pairs { read_u16(data_ptr) };
-                    data_ptr += 8;
-
-                    for (std::size_t j = 0; j < num_pairs; ++j)
-                    {
-                        uint16_t left  { read_u16(data_ptr + j * 6 + 0) };
-                        uint16_t right { read_u16(data_ptr + j * 6 + 2) };
-                        int16_t value  { read_s16(data_ptr + j * 6 + 4) };
-                        font->set_kerning(left, right, value);
-                    }
-                }
-                subtable_ptr += st_length;
-            }
-        }
+        parse_kern_table(kern_table, kern_table + it_kern->second.length, kerning);
+    }
 
+    auto it_gpos { tables.find("GPOS") };
+    if (kerning.empty() && it_gpos != tables.end())
+    {
+        const uint8_t* gpos_table { data + it_gpos->second.offset };
+        parse_gpos_table(gpos_table, gpos_table + it_gpos->second.length, num_glyphs, kerning);
     }
 
+    kerning.finalize();
+    font->set_kerning_table(std::move(kerning));
+
     auto it_hmtx { tables.find("hmtx") };
     if (it_hmtx == tables.end())
     {
@@ -367,24 +448,15 @@ std::shared_ptr<FontTTF> FontManagerTTF::load_from_memory(const uint8_t* data, c
         }
     }
 
-    for (auto &[codepoint, glyph_index] : codepoint_to_index)
-    {
-        if (glyph_index < glyph_metrics.size())
-        {
-            font->set_metrics(codepoint, glyph_metrics[glyph_index]);
-        }
-    }
+    font->set_metrics(glyph_metrics);
 
     font->set_name(name);
-    loaded_fonts[name] = font;
 
     return font;
 }
 
-std::unordered_map<uint32_t, uint16_t> FontManagerTTF::parse_cmap_format_4(const std::uint8_t* cmap_table, const uint32_t length)
+void FontManagerTTF::parse_cmap_format_4(const std::uint8_t* cmap_table, const std::uint8_t* cmap_end, CodepointMap &codepoint_map)
 {
-    std::unordered_map<uint32_t, uint16_t> char_to_glyph;
-
     uint16_t seg_count_X2 { read_u16(cmap_table + 6) };
     uint16_t seg_count { static_cast<uint16_t>(seg_count_X2 / 2) };
 
@@ -393,7 +465,10 @@ std::unordered_map<uint32_t, uint16_t> FontManagerTTF::parse_cmap_format_4(const
     const std::uint8_t* id_delta_ptr { start_code_ptr + seg_count * 2 };
     const std::uint8_t* id_range_offset_ptr { id_delta_ptr + seg_count * 2 };
 
-    const std::uint8_t* glyph_id_array_ptr { id_range_offset_ptr + seg_count * 2 };
+    if (id_range_offset_ptr + seg_count * 2 > cmap_end)
+    {
+        throw std::runtime_error("Invalid cmap format 4 subtable length.");
+    }
 
     for (uint16_t i = 0; i < seg_count; ++i)
     {
@@ -407,30 +482,367 @@ std::unordered_map<uint32_t, uint16_t> FontManagerTTF::parse_cmap_format_4(const
             uint16_t glyph_id { 0 };
             if (id_range_offset == 0)
             {
-                glyph_id = static_cast<uint16_t>((c + id_delta) % 0xFFFF);
+                glyph_id = static_cast<uint16_t>((c + id_delta) & 0xFFFF);
             }
             else
             {
                 uint32_t offset { id_range_offset / 2 + (c - start_code) - (seg_count - i) };
                 const std::uint8_t* glyph_id_ptr { id_range_offset_ptr + i * 2 + offset * 2 };
 
-                if (glyph_id_ptr + 1 < cmap_table + length)
+                if (glyph_id_ptr + 1 < cmap_end)
                 {
                     glyph_id = read_u16(glyph_id_ptr);
                     if (glyph_id != 0)
                     {
-                        glyph_id = static_cast<uint16_t>((glyph_id + id_delta) % 0xFFFF);
+                        glyph_id = static_cast<uint16_t>((glyph_id + id_delta) & 0xFFFF);
+                    }
+                }
+            }
+            codepoint_map.set(c, glyph_id);
+        }
+    }
+}
+
+void FontManagerTTF::parse_cmap_format_12(const std::uint8_t* cmap_table, const std::uint8_t* cmap_end, CodepointMap &codepoint_map)
+{
+    uint32_t num_groups { read_u32(cmap_table + 12) };
+    const std::uint8_t* group_ptr { cmap_table + 16 };
+
+    if (group_ptr + static_cast<std::size_t>(num_groups) * 12 > cmap_end)
+    {
+        throw std::runtime_error("Invalid cmap format 12 subtable length.");
+    }
+
+    for (uint32_t i = 0; i < num_groups; ++i)
+    {
+        uint32_t start_code { read_u32(group_ptr + i * 12) };
+        uint32_t end_code { std::min(read_u32(group_ptr + i * 12 + 4), CodepointMap::MAX_CODEPOINT) };
+        uint32_t start_glyph { read_u32(group_ptr + i * 12 + 8) };
+
+        for (uint32_t c = start_code; c <= end_code; ++c)
+        {
+            codepoint_map.set(c, static_cast<uint16_t>(start_glyph + (c - start_code)));
+        }
+    }
+}
+
+void FontManagerTTF::parse_kern_table(const std::uint8_t* kern_table, const std::uint8_t* kern_end, KerningTable &kerning)
+{
+    if (kern_table + 4 > kern_end)
+    {
+        return;
+    }
+
+    uint16_t num_subtables { read_u16(kern_table + 2) };
+    const uint8_t* subtable_ptr { kern_table + 4 };
+
+    for (uint16_t i = 0; i < num_subtables; ++i)
+    {
+        if (subtable_ptr + 14 > kern_end)
+        {
+            break;
+        }
+
+        uint16_t st_length { read_u16(subtable_ptr + 2) };
+        uint16_t st_coverage { read_u16(subtable_ptr + 4) };
+        uint8_t st_format { static_cast<uint8_t>(st_coverage >> 8) };
+        bool horizontal { (st_coverage & 0x0001) != 0 };
+        bool minimum_or_cross_stream { (st_coverage & 0x0006) != 0 };
+
+        if (st_format == 0 && horizontal && !minimum_or_cross_stream)
+        {
+            const uint8_t* data_ptr { subtable_ptr + 6 };
+            std::size_t num_pairs { read_u16(data_ptr) };
+            data_ptr += 8;
+
+            num_pairs = std::min<std::size_t>(num_pairs, (kern_end - data_ptr) / 6);
+
+            for (std::size_t j = 0; j < num_pairs; ++j)
+            {
+                uint16_t left  { read_u16(data_ptr + j * 6 + 0) };
+                uint16_t right { read_u16(data_ptr + j * 6 + 2) };
+                int16_t value  { read_s16(data_ptr + j * 6 + 4) };
+                kerning.add_pair(left, right, value);
+            }
+        }
+
+        if (st_length == 0)
+        {
+            break;
+        }
+        subtable_ptr += st_length;
+    }
+}
+
+static int value_record_size(const uint16_t value_format)
+{
+    return std::popcount(static_cast<uint16_t>(value_format & 0x00FF)) * 2;
+}
+
+static int16_t value_record_x_advance(const std::uint8_t* record, const uint16_t value_format)
+{
+    if (!(value_format & 0x0004))
+    {
+        return 0;
+    }
+    return read_s16(record + std::popcount(static_cast<uint16_t>(value_format & 0x0003)) * 2);
+}
+
+static std::vector<uint16_t> parse_coverage(const std::uint8_t* coverage, const std::uint8_t* table_end)
+{
+    std::vector<uint16_t> glyphs;
+    if (coverage + 4 > table_end)
+    {
+        return glyphs;
+    }
+
+    uint16_t format { read_u16(coverage) };
+    uint16_t count { read_u16(coverage + 2) };
+
+    if (format == 1 && coverage + 4 + count * 2 <= table_end)
+    {
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            glyphs.push_back(read_u16(coverage + 4 + i * 2));
+        }
+    }
+    else if (format == 2 && coverage + 4 + count * 6 <= table_end)
+    {
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            const std::uint8_t* range { coverage + 4 + i * 6 };
+            uint16_t start { read_u16(range) };
+            uint16_t end { read_u16(range + 2) };
+            uint16_t start_index { read_u16(range + 4) };
+
+            // Malformed ranges would wrap the size below; skip them like an empty range.
+            if (end < start)
+            {
+                continue;
+            }
+
+            std::size_t range_end { static_cast<std::size_t>(start_index) + (end - start) + 1 };
+            if (glyphs.size() < range_end)
+            {
+                glyphs.resize(range_end, 0);
+            }
+            for (uint32_t g = start; g <= end; ++g)
+            {
+                glyphs[start_index + (g - start)] = static_cast<uint16_t>(g);
+            }
+        }
+    }
+    return glyphs;
+}
+
+static std::vector<uint16_t> parse_class_def(const std::uint8_t* class_def, const std::uint8_t* table_end, const uint16_t num_glyphs)
+{
+    std::vector<uint16_t> classes(num_glyphs, 0);
+    if (class_def + 4 > table_end)
+    {
+        return classes;
+    }
+
+    uint16_t format { read_u16(class_def) };
+
+    if (format == 1 && class_def + 6 <= table_end)
+    {
+        uint16_t start_glyph { read_u16(class_def + 2) };
+        uint16_t count { read_u16(class_def + 4) };
+        if (class_def + 6 + count * 2 > table_end)
+        {
+            return classes;
+        }
+        for (uint16_t i = 0; i < count && start_glyph + i < num_glyphs; ++i)
+        {
+            classes[start_glyph + i] = read_u16(class_def + 6 + i * 2);
+        }
+    }
+    else if (format == 2)
+    {
+        uint16_t count { read_u16(class_def + 2) };
+        if (class_def + 4 + count * 6 > table_end)
+        {
+            return classes;
+        }
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            const std::uint8_t* range { class_def + 4 + i * 6 };
+            uint16_t start { read_u16(range) };
+            uint16_t end { read_u16(range + 2) };
+            uint16_t value { read_u16(range + 4) };
+            for (uint32_t g = start; g <= end && g < num_glyphs; ++g)
+            {
+                classes[g] = value;
+            }
+        }
+    }
+    return classes;
+}
+
+void FontManagerTTF::parse_gpos_table(const std::uint8_t* gpos_table, const std::uint8_t* gpos_end, const uint16_t num_glyphs, KerningTable &kerning)
+{
+    if (gpos_table + 10 > gpos_end)
+    {
+        return;
+    }
+
+    const std::uint8_t* feature_list { gpos_table + read_u16(gpos_table + 6) };
+    const std::uint8_t* lookup_list { gpos_table + read_u16(gpos_table + 8) };
+
+    if (feature_list + 2 > gpos_end || lookup_list + 2 > gpos_end)
+    {
+        return;
+    }
+
+    uint16_t num_lookups { read_u16(lookup_list) };
+    std::vector<bool> kern_lookups(num_lookups, false);
+
+    uint16_t num_features { read_u16(feature_list) };
+    for (uint16_t i = 0; i < num_features; ++i)
+    {
+        const std::uint8_t* record { feature_list + 2 + i * 6 };
+        if (record + 6 > gpos_end)
+        {
+            break;
+        }
+        if (std::string { reinterpret_cast<const char*>(record), 4 } != "kern")
+        {
+            continue;
+        }
+
+        const std::uint8_t* feature { feature_list + read_u16(record + 4) };
+        if (feature + 4 > gpos_end)
+        {
+            continue;
+        }
+        uint16_t num_indices { read_u16(feature + 2) };
+        for (uint16_t j = 0; j < num_indices && feature + 4 + j * 2 + 2 <= gpos_end; ++j)
+        {
+            uint16_t lookup_index { read_u16(feature + 4 + j * 2) };
+            if (lookup_index < num_lookups)
+            {
+                kern_lookups[lookup_index] = true;
+            }
+        }
+    }
+
+    for (uint16_t i = 0; i < num_lookups; ++i)
+    {
+        if (!kern_lookups[i] || lookup_list + 2 + i * 2 + 2 > gpos_end)
+        {
+            continue;
+        }
+
+        const std::uint8_t* lookup { lookup_list + read_u16(lookup_list + 2 + i * 2) };
+        if (lookup + 6 > gpos_end)
+        {
+            continue;
+        }
+
+        uint16_t lookup_type { read_u16(lookup) };
+        uint16_t num_subtables { read_u16(lookup + 4) };
+
+        for (uint16_t j = 0; j < num_subtables && lookup + 6 + j * 2 + 2 <= gpos_end; ++j)
+        {
+            const std::uint8_t* subtable { lookup + read_u16(lookup + 6 + j * 2) };
+            uint16_t subtable_type { lookup_type };
+
+            if (lookup_type == 9 && subtable + 8 <= gpos_end)
+            {
+                subtable_type = read_u16(subtable + 2);
+                subtable = subtable + read_u32(subtable + 4);
+            }
+
+            if (subtable_type != 2 || subtable + 10 > gpos_end)
+            {
+                continue;
+            }
+
+            uint16_t pos_format { read_u16(subtable) };
+            std::vector<uint16_t> coverage { parse_coverage(subtable + read_u16(subtable + 2), gpos_end) };
+            uint16_t value_format_1 { read_u16(subtable + 4) };
+            uint16_t value_format_2 { read_u16(subtable + 6) };
+            int size_1 { value_record_size(value_format_1) };
+            int size_2 { value_record_size(value_format_2) };
+
+            if (!(value_format_1 & 0x0004))
+            {
+                continue;
+            }
+
+            if (pos_format == 1)
+            {
+                uint16_t num_pair_sets { read_u16(subtable + 8) };
+                for (uint16_t k = 0; k < num_pair_sets && k < coverage.size(); ++k)
+                {
+                    if (subtable + 10 + k * 2 + 2 > gpos_end)
+                    {
+                        break;
+                    }
+                    const std::uint8_t* pair_set { subtable + read_u16(subtable + 10 + k * 2) };
+                    if (pair_set + 2 > gpos_end)
+                    {
+                        continue;
+                    }
+
+                    uint16_t num_pairs { read_u16(pair_set) };
+                    int record_size { 2 + size_1 + size_2 };
+                    if (pair_set + 2 + num_pairs * record_size > gpos_end)
+                    {
+                        continue;
+                    }
+
+                    for (uint16_t p = 0; p < num_pairs; ++p)
+                    {
+                        const std::uint8_t* record { pair_set + 2 + p * record_size };
+                        kerning.add_pair(coverage[k], read_u16(record), value_record_x_advance(record + 2, value_format_1));
+                    }
+                }
+            }
+            else if (pos_format == 2 && subtable + 16 <= gpos_end)
+            {
+                KerningClassTable table;
+                table.left_classes.assign(num_glyphs, KerningClassTable::NOT_COVERED);
+
+                std::vector<uint16_t> class_def_1 { parse_class_def(subtable + read_u16(subtable + 8), gpos_end, num_glyphs) };
+                table.right_classes = parse_class_def(subtable + read_u16(subtable + 10), gpos_end, num_glyphs);
+
+                uint16_t num_left_classes { read_u16(subtable + 12) };
+                table.num_right_classes = read_u16(subtable + 14);
+
+                int record_size { size_1 + size_2 };
+                const std::uint8_t* records { subtable + 16 };
+                if (records + num_left_classes * table.num_right_classes * record_size > gpos_end)
+                {
+                    continue;
+                }
+
+                table.values.resize(num_left_classes * table.num_right_classes);
+                for (int c = 0; c < num_left_classes * table.num_right_classes; ++c)
+                {
+                    table.values[c] = value_record_x_advance(records + c * record_size, value_format_1);
+                }
+
+                for (uint16_t glyph : coverage)
+                {
+                    if (glyph < num_glyphs && class_def_1[glyph] < num_left_classes)
+                    {
+                        table.left_classes[glyph] = class_def_1[glyph];
                     }
-                    else
+                }
+                for (auto &right_class : table.right_classes)
+                {
+                    if (right_class >= table.num_right_classes)
                     {
-                        glyph_id = 0;
+                        right_class = 0;
                     }
                 }
+
+                kerning.add_class_table(std::move(table));
             }
-            char_to_glyph[c] = glyph_id;
         }
     }
-    return char_to_glyph;
 }
 
 std::vector<uint32_t> FontManagerTTF::parse_loca_table(const std::uint8_t* loca_table, const uint16_t num_glyphs, uint16_t index_to_loc_format)
@@ -482,7 +894,13 @@ std::shared_ptr<GlyphTTF> FontManagerTTF::parse_glyph(const std::uint8_t* glyf_t
         }
     };
 
-    if (number_of_contours <= 0)
+    if (number_of_contours < 0)
+    {
+        parse_composite_glyph(glyph_ptr + 10, glyf_table + offset_end, *glyph);
+        return glyph;
+    }
+
+    if (number_of_contours == 0)
     {
         return glyph;
     }
@@ -575,4 +993,90 @@ std::shared_ptr<GlyphTTF> FontManagerTTF::parse_glyph(const std::uint8_t* glyf_t
     return glyph;
 }
 
+void FontManagerTTF::parse_composite_glyph(const std::uint8_t* ptr, const std::uint8_t* glyph_end, GlyphTTF &glyph)
+{
+    static constexpr uint16_t ARG_1_AND_2_ARE_WORDS { 0x0001 };
+    static constexpr uint16_t ARGS_ARE_XY_VALUES { 0x0002 };
+    static constexpr uint16_t WE_HAVE_A_SCALE { 0x0008 };
+    static constexpr uint16_t MORE_COMPONENTS { 0x0020 };
+    static constexpr uint16_t WE_HAVE_AN_X_AND_Y_SCALE { 0x0040 };
+    static constexpr uint16_t WE_HAVE_A_TWO_BY_TWO { 0x0080 };
+    static constexpr uint16_t SCALED_COMPONENT_OFFSET { 0x0800 };
+    static constexpr uint16_t UNSCALED_COMPONENT_OFFSET { 0x1000 };
+
+    auto read_f2dot14 { [](const std::uint8_t* data) {
+        return static_cast<double>(read_s16(data)) / 16384.0;
+    } };
+
+    uint16_t flags { MORE_COMPONENTS };
+    while (flags & MORE_COMPONENTS)
+    {
+        if (ptr + 4 > glyph_end)
+        {
+            throw std::runtime_error("Unexpected end of composite glyph data.");
+        }
+
+        flags = read_u16(ptr);
+        uint16_t glyph_index { read_u16(ptr + 2) };
+        ptr += 4;
+
+        double arg_1 { 0.0 };
+        double arg_2 { 0.0 };
+        if (flags & ARG_1_AND_2_ARE_WORDS)
+        {
+            arg_1 = read_s16(ptr);
+            arg_2 = read_s16(ptr + 2);
+            ptr += 4;
+        }
+        else
+        {
+            arg_1 = static_cast<int8_t>(ptr[0]);
+            arg_2 = static_cast<int8_t>(ptr[1]);
+            ptr += 2;
+        }
+
+        double xx { 1.0 }, xy { 0.0 }, yx { 0.0 }, yy { 1.0 };
+        if (flags & WE_HAVE_A_SCALE)
+        {
+            xx = yy = read_f2dot14(ptr);
+            ptr += 2;
+        }
+        else if (flags & WE_HAVE_AN_X_AND_Y_SCALE)
+        {
+            xx = read_f2dot14(ptr);
+            yy = read_f2dot14(ptr + 2);
+            ptr += 4;
+        }
+        else if (flags & WE_HAVE_A_TWO_BY_TWO)
+        {
+            xx = read_f2dot14(ptr);
+            yx = read_f2dot14(ptr + 2);
+            xy = read_f2dot14(ptr + 4);
+            yy = read_f2dot14(ptr + 6);
+            ptr += 8;
+        }
+
+        // Point-matched placement (args are point indices) is not supported; such components are placed at the origin.
+        Vec2d offset { Vec2d::zero() };
+        if (flags & ARGS_ARE_XY_VALUES)
+        {
+            offset = { arg_1, arg_2 };
+            if ((flags & SCALED_COMPONENT_OFFSET) && !(flags & UNSCALED_COMPONENT_OFFSET))
+            {
+                offset = { xx * offset.x + xy * offset.y, yx * offset.x + yy * offset.y };
+            }
+        }
+
+        glyph.components.push_back({
+            glyph_index,
+            Matrix3x3d {
+                { xx, xy, offset.x },
+                { yx, yy, offset.y },
+                { 0, 0, 1 }
+            }
+        });
+    }
+}
+
 }
+
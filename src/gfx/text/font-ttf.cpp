@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <gfx/text/font-ttf.h>
 #include <gfx/geometry/flatten.h>
+#include <gfx/utils/transform.h>
 
 namespace gfx::text
 {
@@ -10,28 +14,137 @@ using namespace gfx::geometry;
 
 std::shared_ptr<GlyphTTF> FontTTF::get_glyph(const uint32_t codepoint) const
 {
-    auto it = glyphs.find(codepoint);
-    if (it != glyphs.end())
+    return get_glyph_by_index(get_glyph_index(codepoint));
+}
+
+std::shared_ptr<GlyphTTF> FontTTF::get_glyph_by_index(const uint16_t glyph_index) const
+{
+    if (glyph_index == 0 || glyph_index >= glyphs.size())
+    {
+        return nullptr;
+    }
+    return glyphs[glyph_index];
+}
+
+int FontTTF::get_lod_level(const double pixel_size) const
+{
+    if (pixel_size <= 0.0)
+    {
+        return NUM_LOD_LEVELS - 1;
+    }
+
+    // Tolerance in font units that keeps the flattening error under PIXEL_TOLERANCE
+    // once the glyph is scaled to pixel_size, rounded down to the next cached level.
+    double tolerance { PIXEL_TOLERANCE * units_per_em / pixel_size };
+    int level { static_cast<int>(std::floor(std::log2(tolerance / BASE_LOD_TOLERANCE))) };
+    return std::clamp(level, 0, NUM_LOD_LEVELS - 1);
+}
+
+std::vector<ContourEdge> FontTTF::get_glyph_edges(const uint32_t codepoint, const int lod_level) const
+{
+    auto edges { get_glyph_edges_by_index(get_glyph_index(codepoint), lod_level) };
+    return std::vector<ContourEdge>(edges.begin(), edges.end());
+}
+
+std::span<const ContourEdge> FontTTF::get_glyph_edges_by_index(const uint16_t glyph_index, const int lod_level) const
+{
+    return get_cached_glyph_edges(glyph_index, resolve_lod_level(std::clamp(lod_level, 0, NUM_LOD_LEVELS - 1)), 0);
+}
+
+void FontTTF::set_mapped_edges(const int lod_level, std::span<const GlyphEdgeRange> ranges, std::span<const ContourEdge> edges)
+{
+    if (lod_level < 0 || lod_level >= NUM_LOD_LEVELS)
     {
-        return it->second;
+        throw std::runtime_error("Mapped edge level out of range.");
     }
-    return nullptr;
+    mapped_edges[lod_level] = { ranges, edges };
 }
 
-std::vector<ContourEdge> FontTTF::get_glyph_edges(const uint32_t codepoint) const
+int FontTTF::resolve_lod_level(const int lod_level) const
 {
-    auto it = vertex_cache.find(codepoint);
-    if (it != vertex_cache.end())
+    if (!glyphs.empty() || has_mapped_edges(lod_level))
     {
-        return it->second;
+        return lod_level;
     }
 
-    std::vector<ContourEdge> vertices = flatten_glyph(get_glyph(codepoint));
-    vertex_cache[codepoint] = vertices;
-    return vertices;
+    // Without outlines only the mapped levels exist; prefer the nearest finer one.
+    for (int offset = 1; offset < NUM_LOD_LEVELS; ++offset)
+    {
+        if (lod_level - offset >= 0 && has_mapped_edges(lod_level - offset))
+        {
+            return lod_level - offset;
+        }
+        if (lod_level + offset < NUM_LOD_LEVELS && has_mapped_edges(lod_level + offset))
+        {
+            return lod_level + offset;
+        }
+    }
+    return lod_level;
 }
 
-std::vector<ContourEdge> FontTTF::flatten_glyph(const std::shared_ptr<GlyphTTF> glyph) const
+std::span<const ContourEdge> FontTTF::get_cached_glyph_edges(const uint16_t glyph_index, const int lod_level, const int depth) const
+{
+    if (glyph_index == 0)
+    {
+        return {};
+    }
+
+    const auto &mapped { mapped_edges[lod_level] };
+    if (!mapped.ranges.empty())
+    {
+        if (glyph_index >= mapped.ranges.size())
+        {
+            return {};
+        }
+        const auto &range { mapped.ranges[glyph_index] };
+        return mapped.edges.subspan(range.offset, range.count);
+    }
+
+    if (glyph_index >= glyphs.size())
+    {
+        return {};
+    }
+
+    auto &cache { edge_caches[lod_level] };
+    if (cache.valid.empty())
+    {
+        cache.edges.assign(glyphs.size(), {});
+        cache.valid.assign(glyphs.size(), false);
+    }
+
+    if (!cache.valid[glyph_index])
+    {
+        cache.edges[glyph_index] = flatten_glyph(glyphs[glyph_index], lod_level, depth);
+        cache.valid[glyph_index] = true;
+    }
+    return cache.edges[glyph_index];
+}
+
+const GlyphSDF &FontTTF::get_glyph_sdf_by_index(const uint16_t glyph_index) const
+{
+    static const GlyphSDF no_sdf;
+    if (glyph_index == 0 || glyph_index >= num_glyphs)
+    {
+        return no_sdf;
+    }
+
+    if (sdf_cache_valid.empty())
+    {
+        sdf_cache.assign(num_glyphs, {});
+        sdf_cache_valid.assign(num_glyphs, false);
+    }
+
+    if (!sdf_cache_valid[glyph_index])
+    {
+        double texel_size { units_per_em / SDF_TEXELS_PER_EM };
+        auto edges { get_glyph_edges_by_index(glyph_index, get_lod_level(SDF_TEXELS_PER_EM)) };
+        sdf_cache[glyph_index] = generate_glyph_sdf(edges, texel_size, texel_size * SDF_SPREAD_TEXELS);
+        sdf_cache_valid[glyph_index] = true;
+    }
+    return sdf_cache[glyph_index];
+}
+
+std::vector<ContourEdge> FontTTF::flatten_glyph(const std::shared_ptr<GlyphTTF> glyph, const int lod_level, const int depth) const
 {
     std::vector<ContourEdge> edges;
     if (!glyph)
@@ -39,15 +152,43 @@ std::vector<ContourEdge> FontTTF::flatten_glyph(const std::shared_ptr<GlyphTTF>
         return edges;
     }
 
+    if (glyph->is_composite())
+    {
+        if (depth >= MAX_COMPONENT_DEPTH)
+        {
+            return edges;
+        }
+
+        for (const auto &component : glyph->components)
+        {
+            auto component_edges { get_cached_glyph_edges(component.glyph_index, lod_level, depth + 1) };
+            edges.reserve(edges.size() + component_edges.size());
+            for (const auto &edge : component_edges)
+            {
+                edges.push_back({
+                    utils::transform_point(edge.v0, component.transform),
+                    utils::transform_point(edge.v1, component.transform)
+                });
+            }
+        }
+        return edges;
+    }
+
+    double tolerance { get_lod_tolerance(lod_level) };
+
+    std::vector<std::pair<Vec2d, bool>> points_on_off_curve;
+    std::vector<Vec2d> flattened_contour;
+
     for (const auto &contour : glyph->contours)
     {
-        std::vector<std::pair<Vec2d, bool>> points_on_off_curve;
+        points_on_off_curve.clear();
         for (const auto &point : contour)
         {
             points_on_off_curve.push_back({ Vec2d { point.x, point.y }, point.on_curve });
         }
 
-        std::vector<Vec2d> flattened_contour = flatten_contour(points_on_off_curve);
+        flattened_contour.clear();
+        flatten_contour(points_on_off_curve, tolerance, flattened_contour);
         int num_points = flattened_contour.size();
         for (int i = 0; i < num_points; ++i)
         {
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <gfx/text/glyph-sdf.h>
+
+namespace gfx::text
+{
+
+using namespace gfx::math;
+
+
+double GlyphSDF::sample(const Vec2d point) const
+{
+    if (resolution.x < 2 || resolution.y < 2)
+    {
+        return -spread;
+    }
+
+    Vec2d grid { (point - origin) / texel_size };
+    if (grid.x < 0.0 || grid.y < 0.0 || grid.x > resolution.x - 1 || grid.y > resolution.y - 1)
+    {
+        return -spread;
+    }
+
+    int x0 { std::min(static_cast<int>(grid.x), resolution.x - 2) };
+    int y0 { std::min(static_cast<int>(grid.y), resolution.y - 2) };
+    double fx { grid.x - x0 };
+    double fy { grid.y - y0 };
+
+    const float* row0 { distances.data() + y0 * resolution.x + x0 };
+    const float* row1 { row0 + resolution.x };
+
+    double top { row0[0] + (row0[1] - row0[0]) * fx };
+    double bottom { row1[0] + (row1[1] - row1[0]) * fx };
+    return (top + (bottom - top) * fy) * spread;
+}
+
+GlyphSDF generate_glyph_sdf(std::span<const ContourEdge> edges, const double texel_size, const double spread)
+{
+    GlyphSDF sdf;
+    sdf.texel_size = texel_size;
+    sdf.spread = spread;
+
+    if (edges.empty())
+    {
+        return sdf;
+    }
+
+    Box2d bounds { edges[0].v0, edges[0].v0 };
+    for (const auto &edge : edges)
+    {
+        bounds.expand(edge.v0);
+        bounds.expand(edge.v1);
+    }
+
+    Vec2d padding { spread, spread };
+    Vec2d extent { bounds.size() + padding * 2.0 };
+
+    sdf.origin = bounds.min - padding;
+    sdf.resolution = Vec2i {
+        static_cast<int>(std::ceil(extent.x / texel_size)) + 1,
+        static_cast<int>(std::ceil(extent.y / texel_size)) + 1
+    };
+    sdf.distances.resize(static_cast<size_t>(sdf.resolution.x) * sdf.resolution.y);
+
+    struct Crossing
+    {
+        double x;
+        int winding;
+    };
+
+    std::vector<Crossing> crossings;
+    crossings.reserve(edges.size());
+
+    for (int y = 0; y < sdf.resolution.y; ++y)
+    {
+        double py { sdf.origin.y + y * texel_size };
+
+        // Non-zero winding along the row decides the sign; crossings are sorted once
+        // and consumed left to right as the texels advance.
+        crossings.clear();
+        for (const auto &edge : edges)
+        {
+            if ((edge.v0.y <= py) == (edge.v1.y <= py))
+            {
+                continue;
+            }
+
+            double t { (py - edge.v0.y) / (edge.v1.y - edge.v0.y) };
+            crossings.push_back({ edge.v0.x + t * (edge.v1.x - edge.v0.x), edge.v1.y > edge.v0.y ? 1 : -1 });
+        }
+
+        std::sort(crossings.begin(), crossings.end(), [](const Crossing &a, const Crossing &b) {
+            return a.x < b.x;
+        });
+
+        size_t next_crossing = 0;
+        int winding = 0;
+
+        for (int x = 0; x < sdf.resolution.x; ++x)
+        {
+            Vec2d point { sdf.origin.x + x * texel_size, py };
+
+            while (next_crossing < crossings.size() && crossings[next_crossing].x < point.x)
+            {
+                winding += crossings[next_crossing++].winding;
+            }
+
+            double min_distance_sq { std::numeric_limits<double>::max() };
+            for (const auto &edge : edges)
+            {
+                Vec2d segment { edge.v1 - edge.v0 };
+                Vec2d offset { point - edge.v0 };
+
+                double length_sq { segment.x * segment.x + segment.y * segment.y };
+                double t { length_sq > 0.0 ? std::clamp((offset.x * segment.x + offset.y * segment.y) / length_sq, 0.0, 1.0) : 0.0 };
+
+                Vec2d delta { offset - segment * t };
+                min_distance_sq = std::min(min_distance_sq, delta.x * delta.x + delta.y * delta.y);
+            }
+
+            double distance { std::sqrt(min_distance_sq) / spread };
+            if (winding == 0)
+            {
+                distance = -distance;
+            }
+
+            sdf.distances[y * sdf.resolution.x + x] = static_cast<float>(std::clamp(distance, -1.0, 1.0));
+        }
+    }
+
+    return sdf;
+}
+
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <gfx/text/kerning-table.h>
+
+namespace gfx::text
+{
+
+int KerningTable::get(const uint16_t left, const uint16_t right) const
+{
+    uint32_t key { make_key(left, right) };
+
+    auto it { std::lower_bound(pairs.begin(), pairs.end(), key, [](const KerningPair &pair, const uint32_t k) {
+        return pair.key < k;
+    }) };
+
+    if (it != pairs.end() && it->key == key)
+    {
+        return it->value;
+    }
+
+    for (const auto &table : class_tables)
+    {
+        if (left >= table.left_classes.size())
+        {
+            continue;
+        }
+
+        uint16_t left_class { table.left_classes[left] };
+        if (left_class == KerningClassTable::NOT_COVERED)
+        {
+            continue;
+        }
+
+        uint16_t right_class { right < table.right_classes.size() ? table.right_classes[right] : static_cast<uint16_t>(0) };
+        return table.values[left_class * table.num_right_classes + right_class];
+    }
+
+    return 0;
+}
+
+void KerningTable::add_pair(const uint16_t left, const uint16_t right, const int16_t value)
+{
+    pairs.push_back({ make_key(left, right), value });
+}
+
+void KerningTable::add_class_table(KerningClassTable &&table)
+{
+    class_tables.push_back(std::move(table));
+}
+
+void KerningTable::finalize()
+{
+    std::stable_sort(pairs.begin(), pairs.end(), [](const KerningPair &a, const KerningPair &b) {
+        return a.key < b.key;
+    });
+
+    pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const KerningPair &a, const KerningPair &b) {
+        return a.key == b.key;
+    }), pairs.end());
+
+    pairs.shrink_to_fit();
+}
+
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <gfx/utils/bmp-decoder.h>
+#include <gfx/utils/mapped-file.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define GFX_BMP_SSSE3
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace gfx::utils
+{
+
+using namespace gfx::core::types;
+
+static_assert(sizeof(Color4) == 4, "BMP rows are converted straight into Color4 storage");
+static_assert(std::is_trivially_copyable_v<Color4>, "BMP rows are converted straight into Color4 storage");
+
+template <typename T>
+static T read_le(const uint8_t* data, const std::size_t offset)
+{
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+#if defined(GFX_BMP_SSSE3)
+// The shuffle paths are compiled for SSSE3 whatever the build flags and only taken when
+// the CPU reports it, so default x86-64 builds use them too. Each returns the number of
+// pixels it converted and leaves the rest of the row to the scalar loop.
+static bool cpu_has_ssse3()
+{
+    static const bool supported { __builtin_cpu_supports("ssse3") != 0 };
+    return supported;
+}
+
+__attribute__((target("ssse3")))
+static int convert_bgr_pixels_ssse3(const uint8_t* src, uint8_t* out, const int width)
+{
+    // Each 16 byte load holds four whole pixels; stop early so the load never runs past the row.
+    const __m128i shuffle { _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) };
+    const __m128i alpha { _mm_set1_epi32(static_cast<int>(0xFF000000)) };
+    int x { 0 };
+    for (; x + 6 <= width; x += 4)
+    {
+        __m128i bgr { _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 3)) };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_or_si128(_mm_shuffle_epi8(bgr, shuffle), alpha));
+    }
+    return x;
+}
+
+__attribute__((target("ssse3")))
+static int convert_bgra_pixels_ssse3(const uint8_t* src, uint8_t* out, const int width)
+{
+    const __m128i shuffle { _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15) };
+    int x { 0 };
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i bgra { _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4)) };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_shuffle_epi8(bgra, shuffle));
+    }
+    return x;
+}
+#endif
+
+// BGR triplets to RGBA with opaque alpha.
+static void convert_bgr_row(const uint8_t* src, Color4* dst, const int width)
+{
+    uint8_t* out { reinterpret_cast<uint8_t*>(dst) };
+    int x { 0 };
+
+#if defined(GFX_BMP_SSSE3)
+    if (cpu_has_ssse3())
+    {
+        x = convert_bgr_pixels_ssse3(src, out, width);
+    }
+#elif defined(__ARM_NEON)
+    for (; x + 16 <= width; x += 16)
+    {
+        uint8x16x3_t bgr { vld3q_u8(src + x * 3) };
+        uint8x16x4_t rgba { { bgr.val[2], bgr.val[1], bgr.val[0], vdupq_n_u8(255) } };
+        vst4q_u8(out + x * 4, rgba);
+    }
+#endif
+
+    for (; x < width; ++x)
+    {
+        out[x * 4 + 0] = src[x * 3 + 2];
+        out[x * 4 + 1] = src[x * 3 + 1];
+        out[x * 4 + 2] = src[x * 3 + 0];
+        out[x * 4 + 3] = 255;
+    }
+}
+
+// BGRA quads to RGBA: swap the red and blue bytes of each pixel.
+static void convert_bgra_row(const uint8_t* src, Color4* dst, const int width)
+{
+    uint8_t* out { reinterpret_cast<uint8_t*>(dst) };
+    int x { 0 };
+
+#if defined(GFX_BMP_SSSE3)
+    if (cpu_has_ssse3())
+    {
+        x = convert_bgra_pixels_ssse3(src, out, width);
+    }
+#elif defined(__ARM_NEON)
+    for (; x + 16 <= width; x += 16)
+    {
+        uint8x16x4_t bgra { vld4q_u8(src + x * 4) };
+        uint8x16x4_t rgba { { bgra.val[2], bgra.val[1], bgra.val[0], bgra.val[3] } };
+        vst4q_u8(out + x * 4, rgba);
+    }
+#endif
+
+    // Written on whole words so that plain SSE2 builds still vectorise the loop.
+    for (; x < width; ++x)
+    {
+        uint32_t pixel { read_le<uint32_t>(src, x * 4) };
+        pixel = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+        std::memcpy(out + x * 4, &pixel, 4);
+    }
+}
+
+void decode_bmp(const uint8_t* data, const std::size_t size, Bitmap &bitmap)
+{
+    if (size < 54 || read_le<uint16_t>(data, 0) != 0x4D42) // 'BM'
+    {
+        throw std::runtime_error { "Not a valid BMP file" };
+    }
+
+    uint32_t data_offset { read_le<uint32_t>(data, 10) };
+    uint32_t dib_header_size { read_le<uint32_t>(data, 14) };
+    if (dib_header_size < 40)
+    {
+        throw std::runtime_error { "Unsupported BMP format: DIB header too small" };
+    }
+
+    int32_t width { read_le<int32_t>(data, 18) };
+    int32_t height { read_le<int32_t>(data, 22) };
+    uint16_t planes { read_le<uint16_t>(data, 26) };
+    uint16_t bit_count { read_le<uint16_t>(data, 28) };
+    uint32_t compression { read_le<uint32_t>(data, 30) };
+
+    if (planes != 1 || (bit_count != 24 && bit_count != 32))
+    {
+        throw std::runtime_error { "Unsupported BMP: Only 24-bit or 32-bit images supported" };
+    }
+
+    if (compression != 0 && compression != 3)
+    {
+        throw std::runtime_error { "Unsupported BMP: Compressed BMPs not supported" };
+    }
+
+    // BI_BITFIELDS: only the standard BGR(A) channel order is supported.
+    if (compression == 3)
+    {
+        if (size < 66 ||
+            read_le<uint32_t>(data, 54) != 0x00FF0000 ||
+            read_le<uint32_t>(data, 58) != 0x0000FF00 ||
+            read_le<uint32_t>(data, 62) != 0x000000FF)
+        {
+            throw std::runtime_error { "Unsupported BMP: Non-standard channel masks" };
+        }
+    }
+
+    if (width <= 0 || height == 0 || height == INT32_MIN)
+    {
+        throw std::runtime_error { "Unsupported BMP: Invalid dimensions" };
+    }
+
+    int rows { height > 0 ? height : -height };
+    std::size_t row_padded { ((static_cast<std::size_t>(bit_count) * width + 31) / 32) * 4 };
+    if (data_offset > size || row_padded * rows > size - data_offset)
+    {
+        throw std::runtime_error { "Truncated BMP file" };
+    }
+
+    gfx::math::Vec2i resolution { width, rows };
+    if (bitmap.resolution != resolution || bitmap.pixels.size() != Bitmap::storage_size(bitmap.layout, resolution))
+    {
+        bitmap.resize(resolution);
+    }
+    bitmap.mipmaps.clear();
+
+    bool bottom_up { height > 0 };
+    bool tiled { bitmap.layout == BitmapLayout::TILED };
+    std::vector<Color4> row_buffer(tiled ? width : 0);
+
+    for (int y = 0; y < rows; ++y)
+    {
+        const uint8_t* src { data + data_offset + row_padded * y };
+        int bitmap_y { bottom_up ? rows - 1 - y : y };
+
+        Color4* dst { tiled ? row_buffer.data() : &bitmap.pixels[static_cast<std::size_t>(bitmap_y) * width] };
+        if (bit_count == 32)
+        {
+            convert_bgra_row(src, dst, width);
+        }
+        else
+        {
+            convert_bgr_row(src, dst, width);
+        }
+
+        if (tiled)
+        {
+            for (int x = 0; x < width; x += Bitmap::TILE_SIZE)
+            {
+                int count { std::min(Bitmap::TILE_SIZE, width - x) };
+                std::copy(row_buffer.begin() + x, row_buffer.begin() + x + count, &bitmap.at(x, bitmap_y));
+            }
+        }
+    }
+    bitmap.touch();
+}
+
+void decode_bmp(const std::filesystem::path &path, Bitmap &bitmap)
+{
+    MappedFile file { path };
+    if (file.empty())
+    {
+        throw std::runtime_error { "Failed to open BMP file: " + path.string() };
+    }
+    decode_bmp(file.data(), file.size(), bitmap);
+}
+
+Bitmap decode_bmp(const std::filesystem::path &path)
+{
+    Bitmap bitmap { gfx::math::Vec2i { 1, 1 } };
+    decode_bmp(path, bitmap);
+    return bitmap;
+}
+
+}
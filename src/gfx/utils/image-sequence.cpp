@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <gfx/utils/image-sequence.h>
+#include <gfx/utils/bmp-decoder.h>
+
+namespace gfx::utils
+{
+
+using namespace gfx::core::types;
+
+ImageSequence::ImageSequence(const PathFunction frame_path, const int num_frames, const std::size_t capacity, const ProcessFunction process)
+    : frame_path(frame_path), process(process), num_frames(num_frames), slots(std::max<std::size_t>(capacity, 1))
+{
+    if (!frame_path)
+    {
+        throw std::runtime_error { "ImageSequence requires a frame path function" };
+    }
+
+    for (std::size_t i = slots.size(); i > 0; --i)
+    {
+        free_slots.push_back(i - 1);
+    }
+
+    worker = std::thread { [this]() { decode_loop(); } };
+}
+
+ImageSequence::~ImageSequence()
+{
+    {
+        std::lock_guard<std::mutex> lock { mutex };
+        stopping = true;
+    }
+    condition.notify_all();
+    worker.join();
+}
+
+bool ImageSequence::acquire(const int index, Bitmap &frame)
+{
+    std::lock_guard<std::mutex> lock { mutex };
+
+    if (error)
+    {
+        condition.notify_all();
+        std::rethrow_exception(std::exchange(error, nullptr));
+    }
+
+    if (index < position)
+    {
+        seek_locked(index);
+        return false;
+    }
+
+    // Playback has passed frames the worker has not started; skip them rather than decode
+    // frames nobody will show. A frame already being decoded is still used when it lands.
+    if (index > next_index && next_index < num_frames)
+    {
+        int skip_to { std::min(index, num_frames) };
+        num_dropped += skip_to - next_index;
+        next_index = skip_to;
+    }
+
+    // Hand out the newest decoded frame not after `index`, dropping the ones it replaces.
+    while (ready_slots.size() > 1 && slots[ready_slots[1]].index <= index)
+    {
+        release_slot(ready_slots.front());
+        ready_slots.pop_front();
+        ++num_dropped;
+    }
+
+    if (ready_slots.empty() || slots[ready_slots.front()].index > index)
+    {
+        return false;
+    }
+
+    std::size_t slot { ready_slots.front() };
+    ready_slots.pop_front();
+    position = slots[slot].index;
+    std::swap(frame, slots[slot].bitmap);
+    release_slot(slot);
+    return true;
+}
+
+void ImageSequence::seek(const int index)
+{
+    std::lock_guard<std::mutex> lock { mutex };
+    seek_locked(index);
+}
+
+int ImageSequence::get_position() const
+{
+    std::lock_guard<std::mutex> lock { mutex };
+    return position;
+}
+
+std::size_t ImageSequence::get_num_buffered() const
+{
+    std::lock_guard<std::mutex> lock { mutex };
+    return ready_slots.size();
+}
+
+std::size_t ImageSequence::get_num_dropped() const
+{
+    std::lock_guard<std::mutex> lock { mutex };
+    return num_dropped;
+}
+
+void ImageSequence::seek_locked(const int index)
+{
+    // A frame still being decoded belongs to the old position and is discarded when it lands.
+    ++generation;
+    for (std::size_t slot : ready_slots)
+    {
+        release_slot(slot);
+    }
+    ready_slots.clear();
+    next_index = std::clamp(index, 0, num_frames);
+    position = next_index;
+}
+
+void ImageSequence::release_slot(const std::size_t slot)
+{
+    slots[slot].index = -1;
+    free_slots.push_back(slot);
+    condition.notify_all();
+}
+
+void ImageSequence::decode_loop()
+{
+    std::unique_lock<std::mutex> lock { mutex };
+
+    while (true)
+    {
+        condition.wait(lock, [this]() {
+            return stopping || (!free_slots.empty() && next_index < num_frames && !error);
+        });
+
+        if (stopping)
+        {
+            return;
+        }
+
+        std::size_t slot { free_slots.back() };
+        free_slots.pop_back();
+        int index { next_index++ };
+        uint64_t decode_generation { generation };
+
+        // The slot is owned by this thread until it is put back on one of the lists.
+        lock.unlock();
+        std::exception_ptr decode_error;
+        try
+        {
+            decode_bmp(frame_path(index), slots[slot].bitmap);
+            if (process)
+            {
+                process(slots[slot].bitmap);
+            }
+        }
+        catch (...)
+        {
+            decode_error = std::current_exception();
+        }
+        lock.lock();
+
+        if (decode_generation != generation)
+        {
+            free_slots.push_back(slot);
+            continue;
+        }
+
+        if (decode_error)
+        {
+            error = decode_error;
+            free_slots.push_back(slot);
+            continue;
+        }
+
+        slots[slot].index = index;
+        ready_slots.push_back(slot);
+    }
+}
+
+}
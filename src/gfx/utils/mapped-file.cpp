@@ -0,0 +1,76 @@
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <gfx/utils/mapped-file.h>
+
+namespace gfx::utils
+{
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+{
+    int fd { ::open(path.c_str(), O_RDONLY) };
+    if (fd < 0)
+    {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + path.string());
+    }
+
+    if (info.st_size <= 0)
+    {
+        ::close(fd);
+        return;
+    }
+
+    void* address { ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0) };
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map file: " + path.string());
+    }
+
+    mapped = static_cast<const uint8_t*>(address);
+    length = static_cast<std::size_t>(info.st_size);
+}
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : mapped(std::exchange(other.mapped, nullptr)), length(std::exchange(other.length, 0))
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        mapped = std::exchange(other.mapped, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+void MappedFile::release()
+{
+    if (mapped)
+    {
+        ::munmap(const_cast<uint8_t*>(mapped), length);
+        mapped = nullptr;
+        length = 0;
+    }
+}
+
+}